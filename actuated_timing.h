@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+
+#include "clock.h"
+#include "detector_input.h"
+
+// Talebe bağlı (actuated) yeşil süresi. Yeşil en az adımın en kısa süresi kadar sürer; ardından
+// yaklaşımda araç olduğu sürece uzar. Döngü doluysa en az bir geçiş süresi (passage) daha verilir;
+// boşsa yeşil son aracın çıkışından passage sonra biter (boşlukla bitiş). Adımın en uzun süresi
+// hiçbir durumda aşılmaz. Talep olmayan yaklaşımın yeşili kısalır, yoğun yaklaşımınki uzar.
+struct ActuatedTiming {
+    const DetectorBank &detectors;
+    Clock::duration passage = std::chrono::seconds(2);
+
+    // Yeşilin bitmesi gereken an. now'dan önce ya da ona eşitse yeşil şimdi biter.
+    Clock::time_point green_end(int approach, Clock::time_point green_start, Clock::time_point now, Clock::duration min_green,
+                                Clock::duration max_green) const {
+        const ApproachDetector &d = detectors[approach];
+        Clock::time_point end = d.occupied ? now + passage : d.last_off + passage;
+        if (end < green_start + min_green) end = green_start + min_green;
+        if (end > green_start + max_green) end = green_start + max_green;
+        return end;
+    }
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#include "clock.h"
+#include "inline_storage.h"
+
+// Kontrolcünün takvim saati. Takvim zamanı monoton saat ile bir fark (offset) üzerinden hesaplanır;
+// çözülmüş takvim (std::tm) önbellekte tutulur. Aynı saniye içindeki okumalar önbellekten döner,
+// saniye değişince yalnızca dakika ve saniye alanları hesaplanır. localtime_r yalnızca saat
+// sınırlarında çağrılır; gün, hafta günü ve yaz saati geçişleri saat başında değiştiği için bu yeterlidir.
+// SETTIME ile saat elle verilmediyse fark her yenilemede sistem saatine göre tazelenir.
+class CivilClock {
+public:
+    static constexpr uint32_t WEEK_SECONDS = 7 * 86400;
+    using ZoneName = InlineString<64>;
+
+    explicit CivilClock(const Clock &mono) : mono(mono) {
+        char tz[64] = "";
+        if (FILE *f = std::fopen("/etc/timezone", "r")) {
+            if (!std::fgets(tz, sizeof(tz), f)) tz[0] = '\0';
+            std::fclose(f);
+        } else if (const char *env = std::getenv("TZ")) {
+            std::snprintf(tz, sizeof(tz), "%s", env);
+        }
+        size_t n = std::strlen(tz);
+        while (n && (tz[n - 1] == '\n' || tz[n - 1] == '\r')) --n;
+        zone = std::string_view(tz, n);
+        sync_system();
+    }
+
+    // Takvim zamanı, Unix epoch'tan nanosaniye.
+    int64_t now_ns() const { return mono_ns() + offset_ns; }
+
+    time_t seconds() const { return time_t(floor_div(now_ns(), 1000000000)); }
+
+    const std::tm &calendar() {
+        time_t s = seconds();
+        if (s == cached) return cal;
+        if (s < hour_start || s >= hour_start + 3600) {
+            refresh(s);
+            return cal;
+        }
+        int r = int(s - hour_start);
+        cal.tm_min = r / 60;
+        cal.tm_sec = r % 60;
+        cached = s;
+        return cal;
+    }
+
+    // Haftanın saniyesi: Pazartesi 00:00:00 sıfırdır.
+    uint32_t week_second() {
+        const std::tm &t = calendar();
+        return uint32_t((t.tm_wday + 6) % 7) * 86400 + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
+    }
+
+    // Geçerli saniyenin başından bu yana geçen nanosaniye; zamanlayıcılar saniye sınırına kurulur.
+    int64_t subsecond_ns() const {
+        int64_t ns = now_ns();
+        return ns - floor_div(ns, 1000000000) * 1000000000;
+    }
+
+    // SETTIME: yerel saat olarak verilen takvim zamanı. mktime yalnızca burada çağrılır.
+    void set_local(std::tm t) {
+        t.tm_isdst = -1;
+        set_time(std::mktime(&t));
+    }
+
+    void set_time(time_t t) {
+        custom.store(true, std::memory_order_release);
+        offset_ns = int64_t(t) * 1000000000 - mono_ns();
+        invalidate();
+    }
+
+    // SETTIMEZONE iki adımdır: apply_timezone ayarı kalıcı olması için /etc/timezone'a yazar ve tzset'i
+    // bir kez çağırır (süreç geneli; --rt ile ana döngüde), set_zone saati yeni dilime geçirir.
+    static void apply_timezone(const char *tz) {
+        if (FILE *f = std::fopen("/etc/timezone", "w")) {
+            std::fprintf(f, "%s\n", tz);
+            std::fclose(f);
+        }
+        setenv("TZ", tz, 1);
+        tzset();
+    }
+
+    void set_zone(std::string_view tz) {
+        zone = tz;
+        invalidate();
+    }
+
+    std::string_view timezone() const { return zone; }
+    bool custom_time() const { return custom.load(std::memory_order_acquire); }
+    int64_t offset() const { return offset_ns; }
+
+    // Sıcak yeniden başlatma: SETTIME ile verilmiş fark geri yüklenir. Monoton saat süreçler
+    // arasında ortak olduğundan fark aynen geçerlidir.
+    void restore_offset(int64_t ns) {
+        custom.store(true, std::memory_order_release);
+        offset_ns = ns;
+        invalidate();
+    }
+
+    unsigned long refreshes = 0;        // localtime_r çağrı sayısı
+
+private:
+    int64_t mono_ns() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(mono.now().time_since_epoch()).count(); }
+
+    static int64_t floor_div(int64_t a, int64_t b) { return a / b - (a % b < 0); }
+
+    void sync_system() {
+        offset_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count() - mono_ns();
+    }
+
+    void invalidate() {
+        cached = -1;
+        hour_start = -3600;
+    }
+
+    void refresh(time_t s) {
+        if (!custom.load(std::memory_order_acquire)) {
+            sync_system();
+            s = seconds();
+        }
+        localtime_r(&s, &cal);
+        ++refreshes;
+        hour_start = s - cal.tm_min * 60 - cal.tm_sec;
+        cached = s;
+    }
+
+    const Clock &mono;
+    std::atomic<int64_t> offset_ns{0};     // --rt: SETTIME zamanlama tarafında yazar, akış ana döngüde okur
+    std::atomic<bool> custom{false};        // offset_ns gibi iki taraftan okunur; fark yazılmadan önce kurulur
+    ZoneName zone;
+    std::tm cal = {};
+    time_t cached = -1;
+    time_t hour_start = -3600;      // önbellekteki takvimin geçerli olduğu saatin başı
+};
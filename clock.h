@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// Zaman kaynağı ve zamanlayıcılar enjekte edilebilir. Gerçek çalışmada steady_clock ve timerfd,
+// simülasyonda ise sanal saat kullanılır; mod kodu ikisini ayırt etmez.
+class Clock {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+    using duration = std::chrono::steady_clock::duration;
+    virtual ~Clock() = default;
+    virtual time_point now() const = 0;
+};
+
+class SteadyClock : public Clock {
+public:
+    time_point now() const override { return std::chrono::steady_clock::now(); }
+};
+
+// Mutlak zamana kurulan tek atımlık zamanlayıcı.
+class DeadlineTimer {
+public:
+    virtual ~DeadlineTimer() = default;
+    virtual void arm_at(Clock::time_point deadline) = 0;
+    virtual void disarm() = 0;
+    void on_expire(std::function<void()> cb) { callback = std::move(cb); }
+
+protected:
+    void fire() {
+        if (callback) callback();
+    }
+    std::function<void()> callback;
+};
+
+class VirtualTimer;
+
+// Sanal saat: zaman yalnızca run_until() ile ilerler ve beklenen bir sonraki zamanlayıcıya atlar.
+// Böylece 24 saatlik bir çalışma milisaniyeler içinde tamamlanır.
+class VirtualClock : public Clock {
+public:
+    time_point now() const override { return current; }
+
+    // Süresi dolan zamanlayıcıları sırayla tetikleyerek saati limit'e kadar ilerletir.
+    void run_until(time_point limit);
+
+    void advance(std::chrono::nanoseconds d) { run_until(current + d); }
+
+private:
+    friend class VirtualTimer;
+    time_point current{};
+    std::vector<VirtualTimer *> timers;
+};
+
+class VirtualTimer : public DeadlineTimer {
+public:
+    explicit VirtualTimer(VirtualClock &clock) : clock(clock) { clock.timers.push_back(this); }
+    ~VirtualTimer() override {
+        auto &t = clock.timers;
+        for (size_t i = 0; i < t.size(); ++i) {
+            if (t[i] == this) {
+                t.erase(t.begin() + i);
+                break;
+            }
+        }
+    }
+
+    void arm_at(Clock::time_point d) override {
+        deadline = d;
+        armed = true;
+    }
+    void disarm() override { armed = false; }
+
+private:
+    friend class VirtualClock;
+    VirtualClock &clock;
+    Clock::time_point deadline{};
+    bool armed = false;
+};
+
+inline void VirtualClock::run_until(time_point limit) {
+    while (true) {
+        VirtualTimer *next = nullptr;
+        for (VirtualTimer *t : timers) {
+            if (t->armed && t->deadline <= limit && (!next || t->deadline < next->deadline)) next = t;
+        }
+        if (!next) break;
+        if (next->deadline > current) current = next->deadline;
+        next->armed = false;
+        next->fire();
+    }
+    current = limit;
+}
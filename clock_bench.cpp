@@ -0,0 +1,83 @@
+// Takvim saati ve zaman çizelgesi ölçümü: eski GETTIME yolu (her okumada mktime + localtime_r) ile
+// önbellekli CivilClock okumasını, ardından çizelgede etkin girdi aramasını karşılaştırır. Saat gerçek
+// zamanda ilerler; her okumada değişen saniye ve saat sınırları da ölçüme girer. Sonuçlar CSV olarak verilir.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target clock_bench
+// Kullanım: clock_bench [okuma]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include "civil_clock.h"
+#include "clock.h"
+#include "time_schedule.h"
+
+// Her okumada sanal saati 1 ms ilerletir; 3.6 milyon okuma bir saatlik çalışmaya karşılık gelir.
+class SteppingClock : public Clock {
+public:
+    time_point now() const override { return t += std::chrono::milliseconds(1); }
+
+private:
+    mutable time_point t{};
+};
+
+template <typename F>
+static double ns_per_op(unsigned long ops, F &&body) {
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / ops;
+}
+
+int main(int argc, char **argv) {
+    const unsigned long reads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::printf("case,ops,ns_per_op,localtime_calls\n");
+    unsigned long sink = 0;
+
+    // Eski yol: SETTIME sonrası her GETTIME, girilen tm'yi mktime ile çözer ve localtime_r ile geri çevirir.
+    {
+        SteppingClock mono;
+        std::tm custom = {};
+        strptime("2026-10-12 06:00:00", "%Y-%m-%d %H:%M:%S", &custom);
+        Clock::time_point set_point = mono.now();
+        double ns = ns_per_op(reads, [&] {
+            for (unsigned long i = 0; i < reads; ++i) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(mono.now() - set_point).count();
+                std::tm t = custom, out;
+                time_t s = std::mktime(&t) + elapsed;
+                localtime_r(&s, &out);
+                sink += out.tm_sec;
+            }
+        });
+        std::printf("mktime_localtime,%lu,%.2f,%lu\n", reads, ns, reads);
+    }
+
+    {
+        SteppingClock mono;
+        CivilClock civil(mono);
+        std::tm start = {};
+        strptime("2026-10-12 06:00:00", "%Y-%m-%d %H:%M:%S", &start);
+        civil.set_local(start);
+        double ns = ns_per_op(reads, [&] {
+            for (unsigned long i = 0; i < reads; ++i) sink += civil.calendar().tm_sec;
+        });
+        std::printf("civil_calendar,%lu,%.2f,%lu\n", reads, ns, civil.refreshes);
+    }
+
+    // Etkin girdi araması: 7 günde 15 dakikada bir geçiş, 672 noktalık tablo.
+    {
+        TimeSchedule schedule;
+        for (uint32_t s = 0; s < 86400; s += 900) schedule.entries.push_back({0x7f, s, "SEQUENCE"});
+        schedule.compile();
+        uint32_t w = 0;
+        double ns = ns_per_op(reads, [&] {
+            for (unsigned long i = 0; i < reads; ++i) {
+                sink += schedule.active(w);
+                w = (w + 7919) % CivilClock::WEEK_SECONDS;
+            }
+        });
+        std::printf("schedule_lookup_%zu,%lu,%.2f,0\n", schedule.table.size(), reads, ns);
+    }
+    return sink == 0;
+}
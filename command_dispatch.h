@@ -0,0 +1,191 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+// Yanıtlar için sabit boyutlu tampon. Komut işleme sırasında heap kullanılmaz; sığmayan kısım kesilir.
+class ReplyBuffer {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    void append(std::string_view s) {
+        size_t n = s.size() <= CAPACITY - len ? s.size() : CAPACITY - len;
+        std::memcpy(buf + len, s.data(), n);
+        len += n;
+        if (n < s.size()) overflow = true;
+    }
+
+    void append(char c) {
+        if (len < CAPACITY) buf[len++] = c;
+        else overflow = true;
+    }
+
+    void append_int(long long v) {
+        char tmp[24];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        append(std::string_view(tmp, res.ptr - tmp));
+    }
+
+    void append_fixed(double v, int precision) {
+        char tmp[48];
+        int n = std::snprintf(tmp, sizeof(tmp), "%.*f", precision, v);
+        if (n > 0) append(std::string_view(tmp, n < (int)sizeof(tmp) ? n : (int)sizeof(tmp) - 1));
+    }
+
+    std::string_view view() const { return std::string_view(buf, len); }
+    size_t size() const { return len; }
+    bool truncated() const { return overflow; }
+    void clear() {
+        len = 0;
+        overflow = false;
+    }
+
+private:
+    char buf[CAPACITY];
+    size_t len = 0;
+    bool overflow = false;
+};
+
+// Komut adları için FNV-1a. constexpr olduğundan tablo derleme zamanında kurulur.
+constexpr uint32_t command_hash(std::string_view s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : s) {
+        h ^= (unsigned char)c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+template <typename Ctx>
+struct CommandSpec {
+    using Handler = void (*)(Ctx &ctx, std::string_view arg, ReplyBuffer &reply);
+    std::string_view name;      // "=" olmadan, örn. "SETMODE"
+    bool takes_arg;             // "SETMODE=FLASH" gibi argüman alır mı
+    Handler handler;
+    std::string_view help;      // INFO ekranındaki açıklama
+    Handler io = nullptr;       // verilirse handler'dan önce çağıranın iş parçacığında çalışır (dosya, tzset)
+};
+
+// Derleme zamanında kurulan mükemmel hash tablosu: her komut adı ayrı bir kovaya düşene kadar
+// tohum denenir. Arama bir hash, bir tablo okuması ve tek bir string_view karşılaştırmasıdır.
+// Kova sayısı komut sayısının en az dört katıdır; böylece uygun tohum birkaç denemede bulunur.
+template <typename Ctx, size_t N>
+struct CommandRegistry {
+    static constexpr size_t BUCKETS = N * 4 <= 64 ? 64 : N * 4 <= 128 ? 128 : 256;
+    static_assert(N <= 127, "komut sayısı kova sayısını aşıyor");
+
+    CommandSpec<Ctx> specs[N] = {};
+    int8_t slots[BUCKETS] = {};
+    uint32_t seed = 0;
+    bool valid = false;
+
+    constexpr const CommandSpec<Ctx> *find(std::string_view name) const {
+        int8_t i = slots[command_hash(name, seed) & (BUCKETS - 1)];
+        if (i < 0 || specs[i].name != name) return nullptr;
+        return &specs[i];
+    }
+
+    constexpr size_t size() const { return N; }
+};
+
+template <typename Ctx, size_t N>
+constexpr CommandRegistry<Ctx, N> make_registry(const CommandSpec<Ctx> (&specs)[N]) {
+    CommandRegistry<Ctx, N> reg{};
+    for (size_t i = 0; i < N; ++i) reg.specs[i] = specs[i];
+    for (uint32_t seed = 0; seed < 10000; ++seed) {
+        for (auto &s : reg.slots) s = -1;
+        bool ok = true;
+        for (size_t i = 0; i < N && ok; ++i) {
+            auto b = command_hash(specs[i].name, seed) & (CommandRegistry<Ctx, N>::BUCKETS - 1);
+            if (reg.slots[b] >= 0) ok = false;
+            else reg.slots[b] = (int8_t)i;
+        }
+        if (ok) {
+            reg.seed = seed;
+            reg.valid = true;
+            break;
+        }
+    }
+    return reg;
+}
+
+// Satır sonundaki '\r', '\n' ve terminalden yazılan "\\r" karakter çiftini atar.
+inline std::string_view trim_frame(std::string_view line) {
+    while (!line.empty()) {
+        if (line.back() == '\r' || line.back() == '\n') {
+            line.remove_suffix(1);
+        } else if (line.size() >= 2 && line.substr(line.size() - 2) == "\\r") {
+            line.remove_suffix(2);
+        } else {
+            break;
+        }
+    }
+    return line;
+}
+
+// Satırı kayıtlı komuta eşler; argüman arg'a yazılır. Bulunamazsa nullptr döner.
+template <typename Ctx, size_t N>
+const CommandSpec<Ctx> *find_command(const CommandRegistry<Ctx, N> &reg, std::string_view line, std::string_view &arg) {
+    line = trim_frame(line);
+    size_t eq = line.find('=');
+    arg = eq == std::string_view::npos ? std::string_view() : line.substr(eq + 1);
+    const CommandSpec<Ctx> *spec = reg.find(line.substr(0, eq));
+    if (!spec || spec->takes_arg != (eq != std::string_view::npos)) return nullptr;
+    return spec;
+}
+
+// Satırı kayıtlı komuta eşler ve işleyicisini çalıştırır. Bulunamazsa false döner.
+template <typename Ctx, size_t N>
+bool dispatch_command(const CommandRegistry<Ctx, N> &reg, Ctx &ctx, std::string_view line, ReplyBuffer &reply) {
+    std::string_view arg;
+    const CommandSpec<Ctx> *spec = find_command(reg, line, arg);
+    if (!spec) return false;
+    if (spec->io) spec->io(ctx, arg, reply);     // ayrı iş parçacığı yoksa aynı yerde çalışır
+    spec->handler(ctx, arg, reply);
+    return true;
+}
+
+// Ortak argüman ayrıştırıcıları (heap kullanmaz).
+
+// "t1-t2-t3-t4" biçimindeki yön sırasını ayrıştırır. Her yön 1..max_heads arasında olmalı ve
+// yalnızca bir kez geçmelidir. Yön sayısını, hata durumunda -1 döndürür.
+inline int parse_order(std::string_view s, int *order, int max_heads) {
+    uint64_t used = 0;
+    int count = 0;
+    size_t i = 0;
+    while (i <= s.size()) {
+        size_t dash = s.find('-', i);
+        std::string_view parca = s.substr(i, dash == std::string_view::npos ? std::string_view::npos : dash - i);
+        if (parca.size() < 2 || parca[0] != 't') return -1;     // "t1" formatına uymayan bir parça
+        int yon = 0;
+        auto res = std::from_chars(parca.data() + 1, parca.data() + parca.size(), yon);
+        if (res.ec != std::errc() || res.ptr != parca.data() + parca.size()) return -1;
+        if (yon < 1 || yon > max_heads || count >= max_heads) return -1;    // 't5' gibi geçersiz bir yön
+        if (used & (uint64_t(1) << (yon - 1))) return -1;                   // aynı yön birden fazla kullanılmış
+        used |= uint64_t(1) << (yon - 1);
+        order[count++] = yon - 1;
+        if (dash == std::string_view::npos) break;
+        i = dash + 1;
+    }
+    return count;
+}
+
+// Sıranın 0..count-1 yönlerinin her birini tam bir kez içerip içermediğini denetler (durum kaydı için).
+inline bool valid_order(const int *order, int count) {
+    uint64_t used = 0;
+    for (int i = 0; i < count; ++i) {
+        if (order[i] < 0 || order[i] >= count || (used & (uint64_t(1) << order[i]))) return false;
+        used |= uint64_t(1) << order[i];
+    }
+    return true;
+}
+
+// Negatif olmayan tam sayı ayrıştırır; tüm metin sayı değilse false döner.
+inline bool parse_uint(std::string_view s, int &value) {
+    if (s.empty()) return false;
+    auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+    return res.ec == std::errc() && res.ptr == s.data() + s.size() && value >= 0;
+}
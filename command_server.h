@@ -0,0 +1,284 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "command_dispatch.h"
+#include "controller.h"
+#include "event_loop.h"
+#include "signal_stream.h"
+
+// Protokol komutları için eşzamanlı sunucu. TCP ve Unix soketlerinden gelen istemciler aynı olay
+// döngüsünde işlenir. Komutlar '\r' ile (terminal için '\n' de kabul edilir) ayrılır; bir okumada
+// gelen bütün komutlar işlenir ve yanıtları tek write ile gönderilir. Her yanıt '\r' ile biter.
+// SUBSCRIBE komutu bağlantıya özeldir ve burada işlenir: istemci bundan sonra her geçişi EVENT satırı
+// olarak alır (bkz. SignalStream), UNSUBSCRIBE ile akış durur. Yanıtlar ve EVENT satırları aynı
+// sokete satır bütünlüğü bozulmadan sırayla yazılır.
+class CommandServer {
+public:
+    static constexpr size_t MAX_FRAME = 1024;           // daha uzun komutlar atılır
+    static constexpr size_t MAX_PENDING_OUT = 64 * 1024; // aşılırsa istemciden okuma durdurulur
+    static constexpr int MAX_READS_PER_EVENT = 16;
+    static constexpr int MAX_IOV = 16;
+
+    CommandServer(EventLoop &loop, Controller &controller, SignalStream *stream = nullptr)
+        : loop(loop), controller(controller), stream(stream) {
+        if (stream) stream->on_pending = [this] { schedule_stream_flush(); };
+    }
+
+    ~CommandServer() {
+        if (stream) stream->on_pending = nullptr;
+        for (auto &c : clients) {
+            if (c.second->subscribed) stream->unsubscribe(*c.second->stream);
+            close(c.first);
+        }
+        for (int fd : listeners) {
+            loop.unwatch(fd);
+            close(fd);
+        }
+        if (!unix_path.empty()) unlink(unix_path.c_str());
+    }
+
+    // Sunucuda kimlik doğrulama yoktur; varsayılan olarak yalnızca yerel makineden bağlanılır.
+    // Ağa açmak için adres açıkça verilir (ör. "0.0.0.0" ya da bakım ağının arabirimi).
+    bool listen_tcp(uint16_t port, const char *bind_addr = "127.0.0.1") {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, bind_addr, &addr.sin_addr) != 1) return false;
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        return add_listener(fd, (sockaddr *)&addr, sizeof(addr));
+    }
+
+    bool listen_unix(const std::string &path) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return false;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            close(fd);
+            return false;
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        unlink(path.c_str());       // önceki çalışmadan kalan soket dosyası
+        if (!add_listener(fd, (sockaddr *)&addr, sizeof(addr))) return false;
+        unix_path = path;
+        return true;
+    }
+
+    size_t client_count() const { return clients.size(); }
+    unsigned long commands_handled = 0;
+
+private:
+    struct Client {
+        int fd;
+        char in[MAX_FRAME];
+        size_t in_len = 0;
+        bool discarding = false;    // çok uzun bir çerçevenin sonu bekleniyor
+        std::string out;            // gönderilmeyi bekleyen yanıtlar
+        bool reading = true;
+        uint32_t events = EPOLLIN | EPOLLRDHUP;     // epoll'a kayıtlı olaylar
+        std::unique_ptr<SubscriberQueue> stream;   // SUBSCRIBE sonrası bekleyen EVENT satırları
+        bool subscribed = false;
+    };
+
+    bool add_listener(int fd, sockaddr *addr, socklen_t len) {
+        if (bind(fd, addr, len) != 0 || listen(fd, 128) != 0) {
+            close(fd);
+            return false;
+        }
+        listeners.push_back(fd);
+        return loop.watch(fd, EPOLLIN, [this, fd](uint32_t) { accept_clients(fd); });
+    }
+
+    void accept_clients(int lfd) {
+        while (true) {
+            int fd = accept4(lfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;     // EAGAIN: bekleyen bağlantı kalmadı
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));     // Unix soketinde etkisiz
+            auto client = std::make_unique<Client>();
+            client->fd = fd;
+            client->out.reserve(MAX_FRAME);     // yanıtlar kararlı durumda bu tamponda birikir
+            clients[fd] = std::move(client);
+            loop.watch(fd, EPOLLIN | EPOLLRDHUP, [this, fd](uint32_t ev) { on_client(fd, ev); });
+        }
+    }
+
+    void on_client(int fd, uint32_t ev) {
+        auto it = clients.find(fd);
+        if (it == clients.end()) return;
+        Client &c = *it->second;
+        if (ev & EPOLLERR) {
+            drop(fd);
+            return;
+        }
+        bool open = true;
+        if (ev & (EPOLLIN | EPOLLRDHUP)) open = read_frames(c);
+        if (!flush(c) || !open) drop(fd);       // kapanan istemciye son yanıtlar yine de gönderilir
+    }
+
+    // Sokette okunabilen her şeyi okur ve tamamlanan bütün çerçeveleri işler.
+    // İstemci bağlantıyı kapattıysa ya da hata olduysa false döner.
+    bool read_frames(Client &c) {
+        for (int reads = 0; c.reading && reads < MAX_READS_PER_EVENT; ++reads) {     // tek istemci döngüyü tekelleştirmez
+            ssize_t n = read(c.fd, c.in + c.in_len, sizeof(c.in) - c.in_len);
+            if (n == 0) return false;       // istemci kapattı
+            if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            size_t end = c.in_len + n;
+            size_t start = 0;
+            for (size_t i = c.in_len; i < end; ++i) {
+                if (c.in[i] != '\r' && c.in[i] != '\n') continue;
+                if (!c.discarding && i > start) handle_frame(c, std::string_view(c.in + start, i - start));
+                c.discarding = false;
+                start = i + 1;
+            }
+            if (start == 0 && end == sizeof(c.in)) {      // çerçeve tampona sığmıyor; atılan çerçeve başına tek yanıt
+                if (!c.discarding) append_reply(c, "Hatalı komut! Komut çok uzun.\n");
+                c.discarding = true;
+                start = end;
+            }
+            std::memmove(c.in, c.in + start, end - start);
+            c.in_len = end - start;
+            if (c.out.size() > MAX_PENDING_OUT) pause_reading(c);
+        }
+        return true;
+    }
+
+    void handle_frame(Client &c, std::string_view frame) {
+        std::string_view name = trim_frame(frame);
+        if (stream && (name == "SUBSCRIBE" || name == "UNSUBSCRIBE")) {
+            ++commands_handled;
+            if (name == "SUBSCRIBE") subscribe(c);
+            else unsubscribe(c);
+            return;
+        }
+        reply.clear();
+        controller.handle_line(frame, reply, uint16_t(c.fd));
+        ++commands_handled;
+        append_reply(c, reply.view());
+    }
+
+    // Yanıtın son satır sonu protokoldeki '\r' ile değiştirilir.
+    static void append_reply(Client &c, std::string_view r) {
+        if (!r.empty() && r.back() == '\n') r.remove_suffix(1);
+        c.out.append(r.data(), r.size());
+        c.out.push_back('\r');
+    }
+
+    // Abonelik yanıtı; ardından o anki durum cause:SUBSCRIBE ile gelir.
+    void subscribe(Client &c) {
+        if (!c.stream) c.stream = std::make_unique<SubscriberQueue>(stream->pool);
+        if (!c.subscribed) {
+            stream->subscribe(*c.stream, controller.out.state());
+            subscribers.push_back(c.fd);
+            c.subscribed = true;
+        }
+        reply.clear();
+        reply.append("SUBSCRIBED=seq:");
+        reply.append_int(stream->seq);
+        reply.append(",queue:");
+        reply.append_int(SubscriberQueue::CAPACITY);
+        append_reply(c, reply.view());
+    }
+
+    // Yeni satır eklenmez; kuyrukta bekleyenler yine gönderilir.
+    void unsubscribe(Client &c) {
+        reply.clear();
+        reply.append("UNSUBSCRIBED=dropped:");
+        reply.append_int(c.stream ? c.stream->dropped : 0);
+        append_reply(c, reply.view());
+        if (c.subscribed) end_stream(c);
+    }
+
+    void end_stream(Client &c) {
+        stream->unsubscribe(*c.stream);
+        c.subscribed = false;
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), c.fd), subscribers.end());
+    }
+
+    // Geçiş yolu yalnızca kuyruklara ekler; yazmalar aynı uyanışın sonunda, bütün aboneler için bir kez yapılır.
+    void schedule_stream_flush() {
+        if (stream_flush_pending) return;
+        stream_flush_pending = true;
+        loop.defer([this] { flush_subscribers(); });
+    }
+
+    // Soketi dolu olan (EPOLLOUT bekleyen) aboneye yazılmaz; kuyruğu dolarsa satırları birleşir.
+    void flush_subscribers() {
+        stream_flush_pending = false;
+        for (size_t i = subscribers.size(); i-- > 0;) {     // drop() sondakini i'ye taşır, o zaten işlendi
+            Client &c = *clients[subscribers[i]];
+            if (c.events & EPOLLOUT) continue;
+            if (!flush(c)) drop(c.fd);
+        }
+    }
+
+    // Önce yarım kalmış EVENT satırı, sonra komut yanıtları, sonra bekleyen EVENT satırları tek writev ile gönderilir.
+    bool flush(Client &c) {
+        SubscriberQueue *q = c.stream.get();
+        if (!c.out.empty() || (q && !q->empty())) {
+            iovec iov[MAX_IOV];
+            int n = 0;
+            bool resume_frame = q && q->mid_frame();
+            if (resume_frame) n += q->fill(iov, 1);
+            if (!c.out.empty()) iov[n++] = {c.out.data(), c.out.size()};
+            if (q) n += q->fill(iov + n, MAX_IOV - n, resume_frame ? 1 : 0);
+            ssize_t w = writev(c.fd, iov, n);
+            if (w < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+            if (w > 0) {
+                size_t left = w;
+                if (resume_frame) left = q->consume(left, 1);
+                size_t r = std::min(left, c.out.size());
+                c.out.erase(0, r);
+                if (q) q->consume(left - r);
+            }
+        }
+        uint32_t ev = EPOLLRDHUP;
+        if (!c.out.empty() || (q && !q->empty())) ev |= EPOLLOUT;
+        if (c.out.size() <= MAX_PENDING_OUT) {
+            c.reading = true;
+            ev |= EPOLLIN;
+        }
+        if (ev != c.events) {       // olaylar yalnızca değiştiğinde yeniden kaydedilir
+            loop.modify(c.fd, ev);
+            c.events = ev;
+        }
+        return true;
+    }
+
+    void pause_reading(Client &c) { c.reading = false; }
+
+    void drop(int fd) {
+        if (clients[fd]->subscribed) end_stream(*clients[fd]);
+        loop.unwatch(fd);
+        close(fd);
+        clients.erase(fd);
+    }
+
+    EventLoop &loop;
+    Controller &controller;
+    SignalStream *stream;
+    bool stream_flush_pending = false;
+    std::vector<int> subscribers;       // abone istemcilerin fd'leri
+    ReplyBuffer reply;
+    std::vector<int> listeners;
+    std::string unix_path;
+    std::unordered_map<int, std::unique_ptr<Client>> clients;
+};
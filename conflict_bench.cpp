@@ -0,0 +1,86 @@
+// Çakışma denetiminin maliyeti. 64 grupluk bir kavşakta (8 aşama x 8 uyumlu grup) geçerli bir çevrimi
+// yeşil bit kümeleri üzerinden denetler; ardından 16 gruplu bir kavşakta commit yolunu denetimli ve
+// denetimsiz karşılaştırır. Sonuçlar CSV olarak verilir.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target conflict_bench
+// Kullanım: conflict_bench [çevrim]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "clock.h"
+#include "conflict_monitor.h"
+#include "gpio_output.h"
+#include "signal_plan.h"
+
+template <typename F>
+static double ns_per_op(unsigned long ops, F &&body) {
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / ops;
+}
+
+int main(int argc, char **argv) {
+    const int cycles = argc > 1 ? std::atoi(argv[1]) : 200000;
+    std::printf("case,groups,checks,ns_per_check,violations\n");
+
+    // 64 grup: her aşamada 8 grup birlikte yeşil, aşamalar arasında 4 sn tüm kırmızı.
+    {
+        const int groups = 64, stages = 8;
+        static ConflictRules rules(groups, 3000);
+        for (int s = 0; s < stages; ++s) rules.set_compatible(uint64_t(0xff) << (s * 8));
+        ConflictMonitor monitor(rules);
+        Clock::time_point t{};
+        unsigned long checks = 0, ok = 0;
+        double ns = ns_per_op((unsigned long)cycles * stages * 2, [&] {
+            for (int c = 0; c < cycles; ++c) {
+                for (int s = 0; s < stages; ++s) {
+                    ok += monitor.admit_green(uint64_t(0xff) << (s * 8), t);
+                    t += std::chrono::seconds(10);
+                    ok += monitor.admit_green(0, t);
+                    t += std::chrono::seconds(4);
+                    checks += 2;
+                }
+            }
+        });
+        std::printf("admit_green,%d,%lu,%.2f,%lu\n", groups, checks, ns, monitor.violations);
+        // Reddedilen istek: çakışan iki aşama birden.
+        ns = ns_per_op(checks, [&] {
+            for (unsigned long i = 0; i < checks; ++i) ok += monitor.admit_green(0xffff, t);
+        });
+        std::printf("admit_green_reject,%d,%lu,%.2f,%lu\n", groups, checks, ns, monitor.violations);
+        if (ok == 0) return 1;
+    }
+
+    // 16 grup: derlenmiş bir planın adımları commit yolundan geçer; denetimli ve denetimsiz.
+    {
+        const int groups = 16;
+        std::vector<int> order;
+        for (int g = 0; g < groups; ++g) order.push_back(g);
+        SignalPlan plan = order_plan("BENCH", order.data(), order.size(), groups, 5, 5);
+        std::vector<OutputPin> pins;
+        for (int bit = 0; bit < groups * BITS_PER_HEAD; ++bit) pins.push_back({bit / 32, bit % 32});
+        ConflictRules rules(groups, 3000);
+        for (int checked = 0; checked < 2; ++checked) {
+            MockBackend backend;
+            JunctionOutput out(backend, pins);
+            out.init(0);
+            VirtualClock clock;
+            ConflictMonitor monitor(rules, &clock);
+            if (checked) out.monitor = &monitor;
+            unsigned long commits = (unsigned long)cycles / 4 * plan.steps.size();
+            double ns = ns_per_op(commits, [&] {
+                for (int c = 0; c < cycles / 4; ++c) {
+                    for (const PlanStep &s : plan.steps) {
+                        out.commit(s.outputs);
+                        clock.advance(std::chrono::milliseconds(s.min_ms));
+                    }
+                }
+            });
+            std::printf("%s,%d,%lu,%.2f,%lu\n", checked ? "commit_checked" : "commit_unchecked", groups, commits, ns, monitor.violations);
+        }
+    }
+    return 0;
+}
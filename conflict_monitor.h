@@ -0,0 +1,170 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "clock.h"
+#include "output_mask.h"
+
+// Çakışma kuralları: hangi grupların aynı anda yeşil yanamayacağı ve bir grubun yeşili bittikten
+// sonra çakışan bir grubun yeşile geçebilmesi için gereken en kısa ara süre (intergreen).
+// Varsayılan olarak bütün gruplar birbiriyle çakışır; aynı anda yanabilecekler açıkça belirtilir.
+struct ConflictRules {
+    static constexpr int MAX = 64;
+
+    int groups = 0;
+    uint64_t conflicts[MAX] = {};           // conflicts[i] bit j: i ile j aynı anda yeşil olamaz
+    uint32_t intergreen_ms[MAX][MAX] = {};  // i'nin yeşili bittikten sonra j için beklenecek süre
+
+    ConflictRules() = default;
+    ConflictRules(int groups, uint32_t default_intergreen_ms) : groups(groups) {
+        uint64_t all = groups >= 64 ? ~uint64_t(0) : (uint64_t(1) << groups) - 1;
+        for (int i = 0; i < groups; ++i) {
+            conflicts[i] = all & ~(uint64_t(1) << i);
+            for (int j = 0; j < groups; ++j) intergreen_ms[i][j] = i == j ? 0 : default_intergreen_ms;
+        }
+    }
+
+    // Kümedeki gruplar birbiriyle çakışmaz.
+    void set_compatible(uint64_t set) {
+        for (int i = 0; i < groups; ++i) {
+            if ((set >> i) & 1) conflicts[i] &= ~set;
+        }
+    }
+
+    void set_intergreen(uint32_t ms) {
+        for (int i = 0; i < groups; ++i) {
+            for (int j = 0; j < groups; ++j) intergreen_ms[i][j] = i == j ? 0 : ms;
+        }
+    }
+};
+
+enum ConflictKind : uint8_t {
+    CONFLICT_NONE = 0,
+    CONFLICT_GREENS = 1,        // çakışan iki grup aynı anda yeşil
+    CONFLICT_INTERGREEN = 2,    // ara süre dolmadan yeşil
+    CONFLICT_LAMPS = 3,         // aynı kafada yeşil ile kırmızı/sarı birlikte
+};
+
+struct ConflictReport {
+    ConflictKind kind = CONFLICT_NONE;
+    int8_t group = -1;          // yeşile geçmek isteyen grup
+    int8_t other = -1;          // çakıştığı grup
+};
+
+// Kavşağın yeşil durumunu bit kümesi olarak tutar ve her önerilen çıkışı GPIO'ya yazılmadan önce
+// denetler. Yalnızca yeşile yeni geçen gruplar için çakışma maskesi ile bir AND yapılır; ara süre
+// yalnızca yakın zamanda yeşili biten çakışan gruplar için karşılaştırılır. Reddedilen çıkış
+// durumu değiştirmez.
+class ConflictMonitor {
+public:
+    ConflictMonitor(const ConflictRules &rules, const Clock *clock = nullptr) : rules(rules), clock(clock) {
+        for (int i = 0; i < rules.groups; ++i) {
+            uint32_t m = 0;
+            for (int j = 0; j < rules.groups; ++j) m = rules.intergreen_ms[i][j] > m ? rules.intergreen_ms[i][j] : m;
+            max_intergreen[i] = std::chrono::milliseconds(m);
+        }
+        int heads = rules.groups < 21 ? rules.groups : 21;      // OutputMask en fazla 21 kafa taşır
+        for (int h = 0; h < heads; ++h) head_bit0 |= OutputMask(1) << (h * BITS_PER_HEAD);
+    }
+
+    // Yeşil grup kümesi (bit i: grup i yeşil). Kabul edilirse iç durum güncellenir.
+    bool admit_green(uint64_t green, Clock::time_point now) {
+        for (uint64_t r = recent; r; r &= r - 1) {       // ara süresi dolanlar listeden çıkar
+            int i = __builtin_ctzll(r);
+            if (now - ended_at[i] >= max_intergreen[i]) recent &= ~(uint64_t(1) << i);
+        }
+        uint64_t starting = green & ~current;
+        for (uint64_t s = starting; s; s &= s - 1) {
+            int g = __builtin_ctzll(s);
+            uint64_t clash = rules.conflicts[g] & green;
+            if (clash) return reject(CONFLICT_GREENS, g, __builtin_ctzll(clash));
+            // Aynı adımda biten çakışan grup için ara süre sıfırdır.
+            for (uint64_t e = current & ~green & rules.conflicts[g]; e; e &= e - 1) {
+                int i = __builtin_ctzll(e);
+                if (rules.intergreen_ms[i][g]) return reject(CONFLICT_INTERGREEN, g, i);
+            }
+            for (uint64_t r = recent & rules.conflicts[g]; r; r &= r - 1) {
+                int i = __builtin_ctzll(r);
+                if (now - ended_at[i] < std::chrono::milliseconds(rules.intergreen_ms[i][g])) return reject(CONFLICT_INTERGREEN, g, i);
+            }
+        }
+        uint64_t ended = current & ~green;
+        for (uint64_t e = ended; e; e &= e - 1) ended_at[__builtin_ctzll(e)] = now;
+        recent = (recent | ended) & ~green;
+        current = green;
+        return true;
+    }
+
+    // Kafa maskesi. Önce her kafanın lamba birleşimi, sonra yeşil grupları denetlenir.
+    bool admit(OutputMask next, Clock::time_point now) {
+        OutputMask red = next & head_bit0, yellow = (next >> 1) & head_bit0, green_bits = (next >> 2) & head_bit0;
+        if (OutputMask bad = green_bits & (red | yellow)) return reject(CONFLICT_LAMPS, __builtin_ctzll(bad) / BITS_PER_HEAD, -1);
+        return admit_green(greens(next), now);
+    }
+
+    // Sıcak yeniden başlatmada ışıklar zaten yanıyordur; yeşil durum denetimsiz olarak kabul edilir.
+    void seed(OutputMask outputs) {
+        current = greens(outputs);
+        recent = 0;
+    }
+
+    bool admit(OutputMask next) { return admit(next, clock ? clock->now() : Clock::time_point()); }
+
+    uint64_t green() const { return current; }
+
+    // Şimdiki yeşiller şu an bitseydi çakışan bir grubun yeşile geçebilmesi için beklenecek en uzun
+    // süre; yakında biten yeşillerin kalan ara süresi de sayılır. Mod değişimindeki ara adımlar için.
+    Clock::duration clearance(Clock::time_point now) const {
+        Clock::duration d{0};
+        for (uint64_t g = current | recent; g; g &= g - 1) {
+            int i = __builtin_ctzll(g);
+            Clock::duration left = (current >> i) & 1 ? max_intergreen[i] : ended_at[i] + max_intergreen[i] - now;
+            if (left > d) d = left;
+        }
+        return d;
+    }
+
+    unsigned long violations = 0;
+    ConflictReport last;
+
+private:
+    uint64_t greens(OutputMask m) const {
+        uint64_t green = 0;
+        for (OutputMask g = (m >> 2) & head_bit0; g; g &= g - 1) green |= uint64_t(1) << (__builtin_ctzll(g) / BITS_PER_HEAD);
+        return green;
+    }
+
+    bool reject(ConflictKind kind, int group, int other) {
+        ++violations;
+        last = {kind, int8_t(group), int8_t(other)};
+        return false;
+    }
+
+    const ConflictRules &rules;
+    const Clock *clock;
+    uint64_t current = 0;       // yeşil gruplar
+    uint64_t recent = 0;        // yeşili biten, ara süresi dolmamış olabilecek gruplar
+    OutputMask head_bit0 = 0;   // her kafanın ilk biti
+    Clock::time_point ended_at[ConflictRules::MAX] = {};
+    Clock::duration max_intergreen[ConflictRules::MAX] = {};
+};
+
+// Açıklamayı buf'a yazar (bellek ayırmaz; çakışma anında geçiş yolundan çağrılır).
+inline void format_conflict(const ConflictReport &r, char *buf, size_t size) {
+    int g = r.group + 1, o = r.other + 1;
+    switch (r.kind) {
+        case CONFLICT_GREENS: std::snprintf(buf, size, "t%d ve t%d aynı anda yeşil", g, o); break;
+        case CONFLICT_INTERGREEN: std::snprintf(buf, size, "t%d bittikten sonra t%d için ara süre dolmadı", o, g); break;
+        case CONFLICT_LAMPS: std::snprintf(buf, size, "t%d kafasında yeşil ile kırmızı/sarı birlikte", g); break;
+        default: std::snprintf(buf, size, "çakışma yok");
+    }
+}
+
+inline std::string describe_conflict(const ConflictReport &r) {
+    char buf[96];
+    format_conflict(r, buf, sizeof(buf));
+    return buf;
+}
@@ -0,0 +1,662 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <string_view>
+
+#include "civil_clock.h"
+#include "clock.h"
+#include "command_dispatch.h"
+#include "gpio_output.h"
+#include "latency_histogram.h"
+#include "mode_runner.h"
+#include "signal_plan.h"
+#include "pin_map.h"
+#include "protocol_trace.h"
+#include "shm_state.h"
+#include "signal_snapshot.h"
+#include "state_checkpoint.h"
+#include "time_schedule.h"
+#include "timing_thread.h"
+
+// Zaman çizelgesi girdisinin çözülmüş hedefi: mod ve PLAN modu için plan.
+struct ScheduleTarget {
+    Mode mode;
+    const SignalPlan *plan;
+};
+
+// Kontrolcünün komutlarla değişen bütün durumu. Komut işleyicileri bu yapı üzerinde çalışır.
+struct Controller {
+    JunctionOutput &out;
+    ModeRunner &runner;
+    Clock &clock;
+    DeadlineTimer &timeoutTimer;
+
+    CivilClock civil{clock};            // takvim saati; SETTIME ve SETTIMEZONE bunu değiştirir
+    ModeScheduler *scheduler = nullptr; // zaman çizelgesi varsa modu o seçer
+    std::vector<ScheduleTarget> scheduleTargets;    // çizelge girdileriyle aynı sırada
+    StateCheckpoint *checkpoint = nullptr;  // verilirse her adımda ve komutta durum kaydedilir
+    ShmStateWriter *shm = nullptr;          // verilirse durum her adımda ve komutta /dev/shm'e yayınlanır
+    ProtocolTraceWriter *trace = nullptr;   // verilirse her komut ve yanıtı iz dosyasına eklenir
+    TimingThread *timing = nullptr;         // --rt: durum bu iş parçacığında değişir, komutlar ona aktarılır
+    std::function<void(std::string_view)> on_notice;   // verilirse ekran mesajları buna gider (NoticeRelay)
+    std::function<void(const CheckpointState &)> on_checkpoint;    // verilirse kayıt dosyaya bunun üzerinden yazılır (CheckpointRelay)
+    int minseqtimeout = 40;             // saniye
+    Mode activemode = Mode::SEQUENCE;
+    Mode initial_mode = Mode::SEQUENCE;     // RESET komutu için başlangıç modunu saklarız.
+    Clock::time_point lastCommandTime;
+    SignalGroupFormatter signalFormatter{runner.head_count};
+    std::chrono::steady_clock::time_point requestTime;     // işlenen komutun ya da zaman aşımının geldiği an
+    LatencyHistogram command_time;      // komut işleme süresi
+    LatencyHistogram mode_switch_time;  // mod isteğinden yeni modun ışıklara yazılmasına kadar geçen süre
+
+    Controller(JunctionOutput &out, ModeRunner &runner, Clock &clock, DeadlineTimer &timeoutTimer)
+        : out(out), runner(runner), clock(clock), timeoutTimer(timeoutTimer) {
+        timeoutTimer.on_expire([this] { on_timeout(); });
+        runner.on_fault = [this] { on_fault(); };
+        runner.on_change = [this] {
+            save_checkpoint();
+            publish_state();
+        };
+    }
+
+    void start() {
+        lastCommandTime = clock.now();      // kronometreyi başlat
+        if (scheduler) {
+            int e = scheduler->start();
+            if (e >= 0) select(scheduleTargets[e]);
+        }
+        out.commit(out.state() | (OutputMask(1) << (runner.head_count * BITS_PER_HEAD)), CAUSE_STARTUP);  // durum LED'i
+        runner.start(activemode, CAUSE_STARTUP);
+        std::cout << "Sistem " << active_name() << " modunda başlatıldı.\n";
+        rearm_timeout();
+    }
+
+    // Kayıttan devam: çıkışlar init ile kayıttaki değerlerle alınmıştır, ışıklar sönmez. Plan ve adım
+    // bulunursa bitiş zamanından devam edilir; bulunamazsa kayıttaki mod, yanan yeşiller sarı ve tüm
+    // kırmızıyla kapatıldıktan sonra baştan başlatılır (ModeRunner::start).
+    void resume(const CheckpointState &s) {
+        lastCommandTime = Clock::time_point(std::chrono::nanoseconds(s.last_command_ns));
+        minseqtimeout = s.minseqtimeout;
+        if (s.custom_time) civil.restore_offset(s.civil_offset_ns);
+        int order[MAX_GROUPS] = {};
+        int n = runner.head_count;
+        for (int i = 0; i < n; ++i) order[i] = s.phase_order[i];
+        if (valid_order(order, n)) runner.set_order(Mode::PHASE, order, n);
+        for (int i = 0; i < n; ++i) order[i] = s.sequence_order[i];
+        if (valid_order(order, n)) runner.set_order(Mode::SEQUENCE, order, n);
+        Mode saved = (Mode)s.mode;
+        activemode = (Mode)s.activemode;
+        if (saved == Mode::PLAN || activemode == Mode::PLAN) {
+            char name[sizeof(s.plan) + 1] = {};
+            std::memcpy(name, s.plan, sizeof(s.plan));
+            runner.customPlan = runner.find_plan(name);
+            if (!runner.customPlan) saved = activemode = initial_mode;      // plan dosyası değişmiş
+        }
+        if (out.monitor) out.monitor->seed(out.state());
+        if (scheduler) scheduler->start();      // çalışan mod korunur; bir sonraki geçiş noktası uygulanır
+        bool resumed = runner.resume(saved, s.step, Clock::time_point(std::chrono::nanoseconds(s.deadline_ns)),
+                                     Clock::time_point(std::chrono::nanoseconds(s.green_start_ns)));
+        if (resumed) {
+            std::cout << "Sistem " << active_name() << " modunda kaldığı yerden devam ediyor (adım " << s.step + 1 << ").\n";
+        } else {
+            runner.start(saved == Mode::NONE ? Mode::NONE : activemode, CAUSE_STARTUP);
+            std::cout << "Sistem " << active_name() << " modunda ışıklar söndürülmeden yeniden başlatıldı.\n";
+        }
+        rearm_timeout();
+        save_checkpoint();
+    }
+
+    void save_checkpoint() {
+        if (!checkpoint) return;
+        auto ns = [](Clock::time_point t) { return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count(); };
+        CheckpointState s = {};
+        s.outputs = out.state();
+        s.deadline_ns = ns(runner.deadline);
+        s.green_start_ns = ns(runner.green_start);
+        s.last_command_ns = ns(lastCommandTime);
+        s.civil_offset_ns = civil.offset();
+        s.step = (uint32_t)runner.exec.index;
+        s.minseqtimeout = minseqtimeout;
+        s.mode = (uint8_t)runner.mode;
+        s.activemode = (uint8_t)activemode;
+        s.custom_time = civil.custom_time();
+        s.head_count = (uint8_t)runner.head_count;
+        s.pin_count = (uint8_t)out.pin_count();
+        for (int i = 0; i < runner.head_count; ++i) {
+            s.phase_order[i] = (int8_t)runner.phaseOrder[i];
+            s.sequence_order[i] = (int8_t)runner.sequenceOrder[i];
+        }
+        if (runner.customPlan) runner.customPlan->name.copy(s.plan, sizeof(s.plan));
+        if (on_checkpoint) on_checkpoint(s);
+        else checkpoint->save(s);
+    }
+
+    // Yerel okuyucular için durum; yalnızca sayaçlar ve alanlar kopyalanır, sistem çağrısı yoktur.
+    void publish_state() {
+        if (!shm) return;
+        auto ns = [](Clock::time_point t) { return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count(); };
+        JunctionState s = {};
+        s.outputs = out.state();
+        s.transitions = out.transitions;
+        s.commands = command_time.count();
+        s.conflicts = out.monitor ? out.monitor->violations : 0;
+        s.heartbeat = shm->publishes + 1;
+        s.updated_ns = ns(clock.now());
+        s.step_deadline_ns = ns(runner.deadline);
+        s.civil_seconds = civil.seconds();
+        s.step = (uint32_t)runner.exec.index;
+        s.step_count = runner.exec.plan ? (uint32_t)runner.exec.plan->steps.size() : 0;
+        s.plan_version = runner.running ? (uint32_t)runner.running->version : 0;
+        s.step_late_max_us = (uint32_t)std::min<uint64_t>(runner.step_lateness.max() / 1000, UINT32_MAX);
+        s.gpio_commit_max_us = (uint32_t)std::min<uint64_t>(out.commit_time.max() / 1000, UINT32_MAX);
+        s.mode = (uint8_t)runner.mode;
+        s.activemode = (uint8_t)activemode;
+        s.head_count = (uint8_t)runner.head_count;
+        active_name().copy(s.mode_name, sizeof(s.mode_name) - 1);
+        shm->publish(s);
+    }
+
+    // Çizelgedeki mod ve plan adlarını çözer. Bilinmeyen ad ya da kafa sayısı uymayan plan hatadır.
+    bool attach_schedule(const TimeSchedule &schedule, ModeScheduler &s, std::string &error) {
+        scheduleTargets.clear();
+        for (const ScheduleEntry &e : schedule.entries) {
+            ScheduleTarget t{parse_mode(e.target), nullptr};
+            if (t.mode == Mode::NONE) {
+                t.plan = runner.find_plan(e.target);
+                if (!t.plan) return error = "bilinmeyen mod ya da plan: " + e.target, false;
+                if (t.plan->groups != runner.head_count) return error = "plan kafa sayısıyla uyuşmuyor: " + e.target, false;
+                t.mode = Mode::PLAN;
+            }
+            scheduleTargets.push_back(t);
+        }
+        scheduler = &s;
+        s.on_switch = [this](int e) { on_schedule(e); };
+        return true;
+    }
+
+    // Gelen bir satırı işler, yanıtı reply'a yazar. source yalnızca protokol izine yazılır (TraceSource).
+    // Komut zamanlama iş parçacığında yürütülür; iz kaydı ve komutun io adımı (dosya, tzset)
+    // çağıranın (ana döngünün) tarafında kalır.
+    void handle_line(std::string_view line, ReplyBuffer &reply, uint16_t source = TRACE_SOURCE_STDIN);
+
+    // Kontrolcü durumuna dokunan işler (istatistik dökümü, heartbeat) için; zamanlama iş parçacığı
+    // yoksa f hemen çalışır.
+    template <typename F>
+    void on_timing_thread(F &&f) {
+        if (timing) timing->call(f);
+        else f();
+    }
+
+    std::string_view active_name() const {
+        if (activemode == Mode::PLAN && runner.customPlan) return runner.customPlan->name;
+        return mode_name(activemode);
+    }
+
+    // Çalışan modu değiştirmeden hedefi seçer; switch_mode ya da start ile uygulanır.
+    void select(const ScheduleTarget &t) {
+        if (t.plan) runner.customPlan = t.plan;
+        activemode = t.mode;
+    }
+
+    // Zaman aşımı ve RESET için dönülecek hedef: çizelge varsa etkin girdisi.
+    ScheduleTarget fallback(Mode m) const {
+        if (scheduler && scheduler->current >= 0) return scheduleTargets[scheduler->current];
+        return {m, nullptr};
+    }
+
+    void switch_mode(Mode m, uint8_t cause = CAUSE_MODE_CHANGE) {
+        activemode = m;
+        runner.start(m, cause);
+        mode_switch_time.record(std::chrono::steady_clock::now() - requestTime);
+        rearm_timeout();
+    }
+
+    // PHASE modunda minseqtimeout saniye komut gelmezse SEQUENCE moduna geçilir. Zamanlayıcı
+    // son komut zamanına kurulur; her saniye uyanıp kontrol etmeye gerek kalmaz.
+    void rearm_timeout() {
+        if (runner.mode == Mode::PHASE) {
+            timeoutTimer.arm_at(lastCommandTime + std::chrono::seconds(minseqtimeout));
+        } else {
+            timeoutTimer.disarm();
+        }
+    }
+
+    // Çakışma denetimi bir çıkışı reddetti; mod FLASH'ta kalır, RESET ya da SETMODE ile çıkılır.
+    void on_fault() {
+        activemode = Mode::FLASH;
+        rearm_timeout();
+        if (const ConflictMonitor *m = out.monitor) {
+            char why[96];
+            format_conflict(m->last, why, sizeof(why));
+            char text[NoticeRelay::MAX_TEXT];
+            std::snprintf(text, sizeof(text), "Çakışma! %s. FLASH moduna geçildi.\nKomut giriniz: ", why);
+            notice(text);
+        }
+    }
+
+    void on_timeout() {
+        if (runner.mode != Mode::PHASE) return;
+        requestTime = std::chrono::steady_clock::now();
+        select(fallback(Mode::SEQUENCE));
+        std::string_view name = active_name();
+        char text[NoticeRelay::MAX_TEXT];
+        std::snprintf(text, sizeof(text), "Zaman aşımı! %d saniyedir komut gelmedi. PHASE modundan %.*s moduna geçiliyor...\n"
+                      "Komut giriniz: ", minseqtimeout, int(name.size()), name.data());
+        notice(text);
+        lastCommandTime = clock.now();      // Kronometreyi sıfırla
+        switch_mode(activemode, CAUSE_TIMEOUT);
+    }
+
+    // Çizelgede bir geçiş noktası geldi; elle seçilmiş mod da olsa girdinin modu uygulanır.
+    void on_schedule(int e) {
+        if (e < 0) return;
+        requestTime = std::chrono::steady_clock::now();
+        select(scheduleTargets[e]);
+        switch_mode(activemode, CAUSE_SCHEDULE);
+        std::string_view name = active_name();
+        char text[NoticeRelay::MAX_TEXT];
+        std::snprintf(text, sizeof(text), "Zaman çizelgesi: %.*s moduna geçildi.\nKomut giriniz: ", int(name.size()), name.data());
+        notice(text);
+    }
+
+    // Zamanlayıcıdan gelen ekran mesajı. --rt ile zamanlama iş parçacığında std::cout kullanılmaz.
+    void notice(std::string_view text) {
+        if (on_notice) on_notice(text);
+        else std::cout << text << std::flush;       // yazılan veriyi hemen ekrana basar
+    }
+
+private:
+    void execute(const CommandSpec<Controller> *spec, std::string_view arg, ReplyBuffer &reply,
+                 std::chrono::steady_clock::time_point arrived);
+};
+
+inline void append_tm(ReplyBuffer &reply, const std::tm &t) {
+    char time_buf[64];
+    size_t n = std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", &t);
+    reply.append(std::string_view(time_buf, n));
+}
+
+inline void append_order(ReplyBuffer &reply, const GroupOrder &order) {     // GETORDER komutu için ışık sıraları
+    for (size_t i = 0; i < order.size(); ++i) {
+        reply.append('t');
+        reply.append_int(order[i] + 1);
+        if (i < order.size() - 1) reply.append('-');
+    }
+}
+
+inline void cmd_getversion(Controller &, std::string_view, ReplyBuffer &reply) {
+    reply.append("VERSION=2.5\n");
+}
+
+inline void cmd_cpuver(Controller &, std::string_view, ReplyBuffer &reply) {
+    reply.append("CPUVER=AM3358BZC\n");
+}
+
+// Takvim önbellekten okunur; localtime_r yalnızca saat başlarında çağrılır.
+inline void cmd_gettime(Controller &c, std::string_view, ReplyBuffer &reply) {
+    reply.append("TIME=");
+    append_tm(reply, c.civil.calendar());
+    reply.append('\n');
+}
+
+inline void cmd_settime(Controller &c, std::string_view arg, ReplyBuffer &reply) {
+    char ftime[64];
+    size_t n = arg.copy(ftime, sizeof(ftime) - 1);
+    ftime[n] = '\0';
+    std::tm t = {};
+    strptime(ftime, "%Y-%m-%d %H:%M:%S", &t);
+    c.civil.set_local(t);       // bundan sonra saat monoton saatle birlikte ilerler
+    reply.append("Zaman güncellendi: ");
+    reply.append(arg);
+    reply.append('\n');
+    if (c.scheduler) c.scheduler->resync();
+}
+
+inline void cmd_gettimezone(Controller &c, std::string_view, ReplyBuffer &reply) {
+    reply.append("TIMEZONE=");
+    reply.append(c.civil.timezone());
+    reply.append('\n');
+}
+
+// /etc/timezone yazımı ve tzset ana döngüde yapılır; zamanlama iş parçacığına yalnızca ad geçer.
+inline void cmd_settimezone_io(Controller &, std::string_view arg, ReplyBuffer &) {
+    CivilClock::ZoneName tz = arg;
+    CivilClock::apply_timezone(tz.c_str());
+}
+
+inline void cmd_settimezone(Controller &c, std::string_view arg, ReplyBuffer &reply) {
+    c.civil.set_zone(arg);
+    reply.append("Zaman dilimi güncellendi: ");
+    reply.append(arg);
+    reply.append('\n');
+    if (c.scheduler) c.scheduler->resync();
+}
+
+// Çizelge girdileri; etkin girdi * ile işaretlenir. next: bir sonraki geçişe kalan saniye.
+inline void cmd_getschedule(Controller &c, std::string_view, ReplyBuffer &reply) {
+    if (!c.scheduler) {
+        reply.append("SCHEDULE=NONE\n");
+        return;
+    }
+    const std::vector<ScheduleTarget> &targets = c.scheduleTargets;
+    reply.append("SCHEDULE=entries:");
+    reply.append_int(targets.size());
+    reply.append(",next:");
+    reply.append_int(c.scheduler->seconds_to_next());
+    reply.append('\n');
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const ScheduleEntry &e = c.scheduler->schedule.entries[i];
+        reply.append((int)i == c.scheduler->current ? "* " : "  ");
+        for (int d = 0; d < 7; ++d) reply.append((e.days >> d) & 1 ? char('1' + d) : '-');
+        reply.append(' ');
+        append_time_of_day(reply, e.second);
+        reply.append(' ');
+        reply.append(e.target);
+        reply.append('\n');
+    }
+}
+
+// Durum tek atomik okumayla alınır ve hazır parçalardan biçimlenir; geçişleri yazan taraf beklemez.
+inline void cmd_getsignalgroup(Controller &c, std::string_view, ReplyBuffer &reply) {
+    char text[SignalGroupFormatter::MAX_REPLY];
+    size_t n = c.signalFormatter.format(c.out.snapshot.load().outputs, text);
+    reply.append(std::string_view(text, n));
+    reply.append('\n');
+}
+
+// SETPHASEORDER ve SETSEQORDER aynı ayrıştırıcıyı ve aynı akışı kullanır.
+inline void set_order(Controller &c, Mode mode, std::string_view arg, ReplyBuffer &reply) {
+    int yeniSira[MAX_GROUPS];
+    bool is_phase = mode == Mode::PHASE;
+    int count = c.runner.head_count;
+    if (parse_order(arg, yeniSira, count) != count) {
+        reply.append(is_phase ? "Hatalı komut! Doğru format: SETPHASEORDER=t1-t2-t3-t4 (" : "Hatalı komut! Format: t1-t2-t3-t4 (");
+        reply.append_int(count);
+        reply.append(" farklı ve geçerli yön kullanın)\n");
+        return;
+    }
+    Clock::duration bound{};
+    bool swapped = c.runner.set_order(mode, yeniSira, count, &bound);
+    reply.append(is_phase ? "Phase sırası güncellendi: " : "Sequence sırası güncellendi: ");
+    reply.append(arg);
+    reply.append('\n');
+    if (swapped) {      // çevrim baştan başlamaz; yeni sıra güvenli sınırda devralınır
+        reply.append(is_phase ? "PHASE modu yeni sıraya kırmızı+sarı sonunda geçecek, en geç " : "SEQUENCE modu yeni sıraya kırmızı+sarı sonunda geçecek, en geç ");
+        reply.append_fixed(std::chrono::duration<double>(bound).count(), 1);
+        reply.append(" sn.\n");
+    } else {
+        reply.append(is_phase ? "Uyarı: Sistem PHASE modunda değil. Sıra kaydedildi ama şu anda uygulanamadı.\n"
+                              : "Uyarı: Sistem SEQUENCE modunda değil. Sıra kaydedildi ama şu anda uygulanamadı.\n");
+    }
+}
+
+inline void cmd_setphaseorder(Controller &c, std::string_view arg, ReplyBuffer &reply) {
+    set_order(c, Mode::PHASE, arg, reply);
+}
+
+inline void cmd_setseqorder(Controller &c, std::string_view arg, ReplyBuffer &reply) {
+    set_order(c, Mode::SEQUENCE, arg, reply);
+}
+
+inline void cmd_getorder(Controller &c, std::string_view, ReplyBuffer &reply) {
+    reply.append("Phase mode sirasi: ");
+    append_order(reply, c.runner.phaseOrder);
+    reply.append("\nSequence mode sirasi: ");
+    append_order(reply, c.runner.sequenceOrder);
+    reply.append('\n');
+}
+
+inline void cmd_getminseqtimeout(Controller &c, std::string_view, ReplyBuffer &reply) {
+    reply.append("MINSEQTIMEOUT=");
+    reply.append_int(c.minseqtimeout);
+    reply.append(" saniye\n");
+}
+
+inline void cmd_setminseqtimeout(Controller &c, std::string_view arg, ReplyBuffer &reply) {
+    int value;
+    if (!parse_uint(arg, value)) {
+        reply.append("Hatalı komut! Zaman aşımı saniye cinsinden bir sayı olmalıdır.\n");
+        return;
+    }
+    c.minseqtimeout = value;
+    reply.append("Minumum zaman aşımı süresi güncellendi: ");
+    reply.append_int(value);
+    reply.append(" saniye\n");
+}
+
+inline void cmd_getmode(Controller &c, std::string_view, ReplyBuffer &reply) {
+    reply.append("ACTIVEMOD=");
+    reply.append(c.active_name());
+    reply.append('\n');
+}
+
+// Aktif modun derlenmiş adım tablosu: her adım için grupların durumu (G/Y/R/U/-) ve süresi.
+inline void cmd_getplan(Controller &c, std::string_view, ReplyBuffer &reply) {
+    const SignalPlan *plan = c.runner.exec.plan;      // yürütülen sürüm
+    if (!plan || plan->steps.empty()) {
+        reply.append("PLAN=NONE\n");
+        return;
+    }
+    reply.append("PLAN=");
+    reply.append(plan->name);
+    reply.append(",groups:");
+    reply.append_int(plan->groups);
+    reply.append(",steps:");
+    reply.append_int(plan->steps.size());
+    reply.append(",current:");
+    reply.append_int(c.runner.exec.index);
+    reply.append(",version:");
+    reply.append_int(c.runner.running->version);
+    if (c.runner.swap.has_pending() || c.runner.waiting) reply.append(",pending:1");
+    reply.append('\n');
+    for (const PlanStep &s : plan->steps) {
+        for (int g = 0; g < plan->groups; ++g) reply.append(signal_char(get_head(s.outputs, g)));
+        reply.append(' ');
+        reply.append_fixed(s.min_ms / 1000.0, 1);
+        if (s.max_ms != s.min_ms) {
+            reply.append('-');
+            reply.append_fixed(s.max_ms / 1000.0, 1);
+        }
+        reply.append('s');
+        if (s.detector >= 0) {
+            reply.append(" detector:t");
+            reply.append_int(s.detector + 1);
+        }
+        reply.append('\n');
+    }
+}
+
+// Mod değişimi çakışma denetimince reddedildiğinde başarı yerine yazılır.
+inline void append_fault(const Controller &c, ReplyBuffer &reply, std::string_view target) {
+    char why[96];
+    format_conflict(c.out.monitor ? c.out.monitor->last : ConflictReport{}, why, sizeof(why));
+    reply.append("Çakışma! ");
+    reply.append(why);
+    reply.append(". ");
+    reply.append(target);
+    reply.append(" başlatılamadı, FLASH moduna geçildi.\n");
+}
+
+inline void cmd_setmode(Controller &c, std::string_view arg, ReplyBuffer &reply) {
+    Mode next = parse_mode(arg);
+    const SignalPlan *plan = next == Mode::NONE ? c.runner.find_plan(arg) : nullptr;
+    if (next == Mode::NONE && !plan) {
+        reply.append("Bilinmeyen mod! SEQUENCE, FLASH, PHASE ya da yüklenmiş bir plan adı kullanın.\n");
+        return;
+    }
+    if (plan) {
+        if (plan->groups != c.runner.head_count) {
+            reply.append("Plan kavşaktaki kafa sayısıyla uyuşmuyor: ");
+            reply.append(plan->name);
+            reply.append('\n');
+            return;
+        }
+        c.runner.customPlan = plan;
+        next = Mode::PLAN;
+    }
+    reply.append("Çalışma modu güncellendi: ");
+    reply.append(arg);
+    reply.append('\n');
+    Mode previous = c.runner.mode;      // yanan yeşiller sarı ve tüm kırmızı ara adımlarıyla kapatılır
+    if (previous != Mode::NONE) {
+        reply.append(mode_name(previous));
+        reply.append(" durduruldu.\n");
+    }
+    c.switch_mode(next);
+    if (c.runner.mode != next) {        // çakışma denetimi yeni modu reddetti, FLASH'a geçildi
+        append_fault(c, reply, arg);
+        return;
+    }
+    reply.append(arg);
+    reply.append(" mode başlatıldı.\n");
+}
+
+inline void cmd_getgpiostats(Controller &c, std::string_view, ReplyBuffer &reply) {
+    const JunctionOutput &out = c.out;
+    reply.append("GPIOSTATS=transitions:");
+    reply.append_int(out.transitions);
+    reply.append(",syscalls:");
+    reply.append_int(out.total_syscalls);
+    reply.append(",last:");
+    reply.append_int(out.last_syscalls);
+    reply.append(",avg:");
+    reply.append_fixed(out.transitions ? double(out.total_syscalls) / out.transitions : 0.0, 2);
+    reply.append(",conflicts:");
+    reply.append_int(out.monitor ? out.monitor->violations : 0);
+    reply.append('\n');
+}
+
+inline void append_histogram(ReplyBuffer &reply, std::string_view name, const LatencyHistogram &h) {
+    reply.append("STATS.");
+    reply.append(name);
+    reply.append("=count:");
+    reply.append_int(h.count());
+    reply.append(",min:");
+    reply.append_fixed(h.min() / 1000.0, 1);
+    const struct { const char *label; double p; } points[] = {{",p50:", 50}, {",p90:", 90}, {",p99:", 99}, {",p999:", 99.9}};
+    for (const auto &pt : points) {
+        reply.append(pt.label);
+        reply.append_fixed(h.percentile(pt.p) / 1000.0, 1);
+    }
+    reply.append(",max:");
+    reply.append_fixed(h.max() / 1000.0, 1);
+    reply.append(",mean:");
+    reply.append_fixed(h.mean() / 1000.0, 1);
+    reply.append('\n');
+}
+
+// Zamanlama kalitesi: değerler mikrosaniyedir. Adım gecikmesi planlanan geçiş anından sapmadır.
+inline void cmd_getstats(Controller &c, std::string_view, ReplyBuffer &reply) {
+    append_histogram(reply, "step_late_us", c.runner.step_lateness);
+    append_histogram(reply, "gpio_commit_us", c.out.commit_time);
+    append_histogram(reply, "command_us", c.command_time);
+    append_histogram(reply, "mode_switch_us", c.mode_switch_time);
+    append_histogram(reply, "plan_swap_us", c.runner.swap_latency);
+}
+
+// Akış bağlantıya özeldir; soket istemcileri için CommandServer işler. Buraya yalnızca standart girişten gelir.
+inline void cmd_subscribe(Controller &, std::string_view, ReplyBuffer &reply) {
+    reply.append("SUBSCRIBE yalnızca TCP ve Unix soket istemcileri içindir (--tcp, --unix).\n");
+}
+
+inline void cmd_geterror(Controller &, std::string_view, ReplyBuffer &reply) {
+    reply.append("ERROR=1\n");
+}
+
+inline void cmd_info(Controller &, std::string_view, ReplyBuffer &reply);
+
+// Zaman çizelgesi varsa başlangıç modu çizelgenin o an etkin girdisidir.
+inline void cmd_reset(Controller &c, std::string_view, ReplyBuffer &reply) {
+    c.select(c.fallback(c.initial_mode));
+    reply.append("Sistem sıfırlanıyor ve başlangıç moduna dönülüyor...\n");
+    reply.append("Aktif mod, başlangıç modu olan '");
+    reply.append(c.active_name());
+    reply.append("' olarak ayarlandı.\n");
+    Mode target = c.activemode;
+    c.switch_mode(target, CAUSE_COMMAND);
+    if (c.runner.mode != target) {
+        append_fault(c, reply, mode_name(target));
+        return;
+    }
+    reply.append("Sistem ");
+    reply.append(c.active_name());
+    reply.append(" modunda yeniden başlatıldı.\n");
+}
+
+inline void cmd_close(Controller &c, std::string_view, ReplyBuffer &reply) {
+    reply.append("Tüm ışıklar kapatılıyor...\n");
+    reply.append("RESET komutu ile sistemi yeniden başlatabilirsiniz.\n");
+    c.runner.start(Mode::NONE, CAUSE_COMMAND);      // zamanlayıcı durur, ışıklar söner
+    c.rearm_timeout();
+}
+
+// Komut tablosu. Sıra INFO ekranındaki sıradır.
+inline constexpr CommandSpec<Controller> controller_command_specs[] = {
+    {"GETVERSION", false, cmd_getversion, "\t\t: Versiyon bilgisi verilir."},
+    {"CPUVER", false, cmd_cpuver, "\t\t\t: İşlemci bilgisi verilir."},
+    {"GETTIME", false, cmd_gettime, "\t\t\t: Anlık zaman bilgisi verilir."},
+    {"SETTIME", true, cmd_settime, "\t\t: y-m-d H:M:S formatında zaman bilgisi değiştirilir. (Örnek: SETTIME=2001-09-17 14:30:15)"},
+    {"GETTIMEZONE", false, cmd_gettimezone, "\t\t: Anlık zaman bölge bilgisi verilir."},
+    {"SETTIMEZONE", true, cmd_settimezone, "\t\t: UTC formatında zaman bölge bilgisi değiştirilir. (Örnek: SETTIMEZONE=UTC+1)", cmd_settimezone_io},
+    {"GETSIGNALGROUP", false, cmd_getsignalgroup, "\t\t: Işıkların anlık durum bilgisi verilir."},
+    {"GETORDER", false, cmd_getorder, "\t\t: Phase ve Sequence modlarındaki ışıkların yanma sıralarını gösterir."},
+    {"SETPHASEORDER", true, cmd_setphaseorder, "\t\t: PHASE modunda ışıkların yanma sırasını değiştirir. (Örnek: SETPHASEORDER=t4-t3-t2-t1)"},
+    {"SETSEQORDER", true, cmd_setseqorder, "\t\t: SEQUENCE modunda ışıkların yanma sırasını değiştirir. (Örnek: SETSEQORDER=t4-t3-t2-t1)"},
+    {"GETMINSEQTIMEOUT", false, cmd_getminseqtimeout, "\t: Zaman aşımı süre bilgisi verilir."},
+    {"SETMINSEQTIMEOUT", true, cmd_setminseqtimeout, "\t: Zaman aşımı süresi değiştirilir."},
+    {"GETMODE", false, cmd_getmode, "\t\t\t: Aktif mod bilgisi verilir."},
+    {"SETMODE", true, cmd_setmode, "\t\t: Aktif mod SEQUENCE, FLASH, PHASE ya da yüklenmiş bir plan olarak değiştirilir. (Örnek: SETMODE=FLASH)"},
+    {"GETPLAN", false, cmd_getplan, "\t\t\t: Aktif planın derlenmiş adım tablosu verilir."},
+    {"GETSCHEDULE", false, cmd_getschedule, "\t\t: Saate ve güne göre mod değiştiren zaman çizelgesi verilir."},
+    {"GETGPIOSTATS", false, cmd_getgpiostats, "\t\t: Geçiş başına GPIO toplu yazma (syscall) ve reddedilen çakışma sayısı verilir."},
+    {"GETSTATS", false, cmd_getstats, "\t\t: Geçiş gecikmesi, GPIO yazma, komut, mod değiştirme ve plan sürümü devralma süre dağılımları (µs) verilir."},
+    {"SUBSCRIBE", false, cmd_subscribe, "\t\t: Her ışık ve mod değişikliği EVENT satırı olarak anında gönderilir (yalnızca soket istemcileri)."},
+    {"UNSUBSCRIBE", false, cmd_subscribe, "\t\t: SUBSCRIBE akışı durdurulur."},
+    {"GETERROR", false, cmd_geterror, "\t\t: Hata bilgisi verilir."},
+    {"RESET", false, cmd_reset, "\t\t\t: Sistem başlangıç modunda ve geçerli değişkenlerde yeniden başlatılır."},
+    {"CLOSE", false, cmd_close, "\t\t\t: Işıklar kapatılır."},
+    {"INFO", false, cmd_info, "\t\t\t: Komut bilgi ekranı açılır."},
+};
+
+inline constexpr auto controller_commands = make_registry(controller_command_specs);
+static_assert(controller_commands.valid, "komut tablosu için çakışmasız hash bulunamadı");
+
+inline void cmd_info(Controller &, std::string_view, ReplyBuffer &reply) {
+    reply.append("\n--- Komut Bilgi Ekranı ---\n");
+    for (const auto &spec : controller_command_specs) {
+        reply.append(spec.name);
+        if (spec.takes_arg) reply.append('=');
+        reply.append(spec.help);
+        reply.append('\n');
+    }
+    reply.append("---------------------------\n");
+}
+
+inline void Controller::handle_line(std::string_view line, ReplyBuffer &reply, uint16_t source) {
+    const std::chrono::steady_clock::time_point arrived = std::chrono::steady_clock::now();
+    std::string_view arg;
+    const CommandSpec<Controller> *spec = find_command(controller_commands, line, arg);
+    if (spec && spec->io) spec->io(*this, arg, reply);
+    on_timing_thread([&] { execute(spec, arg, reply, arrived); });
+    if (trace) trace->record(source, arrived, std::chrono::steady_clock::now() - arrived, line, reply.view());
+}
+
+inline void Controller::execute(const CommandSpec<Controller> *spec, std::string_view arg, ReplyBuffer &reply,
+                                std::chrono::steady_clock::time_point arrived) {
+    requestTime = arrived;
+    lastCommandTime = clock.now();
+    if (spec) spec->handler(*this, arg, reply);
+    else reply.append("Bilinmeyen komut!\n");
+    rearm_timeout();
+    save_checkpoint();
+    command_time.record(std::chrono::steady_clock::now() - arrived);
+    publish_state();
+}
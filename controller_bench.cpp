@@ -0,0 +1,203 @@
+// Kontrolcünün sıcak yolları için regresyon ölçümü: komut ayrıştırma ve dağıtma, GETSIGNALGROUP
+// biçimleme, tam bir geçişin çıkışa yazılması (sahte arka uç, SUBSCRIBE akışı ve libgpiod arka
+// ucu), mod değiştirme ve PHASE zaman aşımı. Saat sanaldır; ölçüm donanım ve zamanlayıcı
+// beklemesi içermez. Her durum partiler halinde çalıştırılır ve CSV olarak işlem başına ortalama
+// ile partiler arası p50/p99 verilir. --baseline ile önceki bir sonuç dosyası verilirse ortalaması
+// --tolerance oranından fazla artan durumlar standart hataya yazılır ve çıkış kodu 2 olur. Kartlara
+// yeni sürüm koymadan önce aynı makinede alınan sonuçla karşılaştırılır.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target controller_bench
+// Kullanım: controller_bench [--quick] [--baseline FILE] [--tolerance 0.25] > sonuc.csv
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "clock.h"
+#include "command_dispatch.h"
+#include "controller.h"
+#include "gpio_output.h"
+#include "mode_runner.h"
+#include "pin_map.h"
+#include "signal_stream.h"
+
+struct BenchResult {
+    std::string name;
+    unsigned long ops;
+    double mean_ns, p50_ns, p99_ns;
+};
+
+// body(n) n işlem yapar. Partilerin işlem başına süreleri sıralanıp yüzdelikler alınır.
+template <typename F>
+static BenchResult run_case(const char *name, int batches, unsigned long per_batch, F &&body) {
+    std::vector<double> ns;
+    ns.reserve(batches);
+    body(per_batch);        // ısınma
+    double total = 0;
+    for (int b = 0; b < batches; ++b) {
+        auto t0 = std::chrono::steady_clock::now();
+        body(per_batch);
+        double d = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        total += d;
+        ns.push_back(d / per_batch);
+    }
+    std::sort(ns.begin(), ns.end());
+    auto pct = [&](double p) { return ns[std::min(ns.size() - 1, size_t(p / 100 * ns.size()))]; };
+    return {name, (unsigned long)batches * per_batch, total / ((double)batches * per_batch), pct(50), pct(99)};
+}
+
+static std::map<std::string, double> load_baseline(const char *path) {
+    std::map<std::string, double> base;
+    FILE *f = std::fopen(path, "r");
+    if (!f) return base;
+    char line[256], name[128];
+    double mean;
+    while (std::fgets(line, sizeof(line), f)) {
+        if (std::sscanf(line, "%127[^,],%*u,%lf", name, &mean) == 2) base[name] = mean;
+    }
+    std::fclose(f);
+    return base;
+}
+
+int main(int argc, char **argv) {
+    bool quick = false;
+    const char *baseline = nullptr;
+    double tolerance = 0.25;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline = argv[++i];
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = std::atof(argv[++i]);
+        else {
+            std::fprintf(stderr, "Kullanım: %s [--quick] [--baseline FILE] [--tolerance 0.25]\n", argv[0]);
+            return 1;
+        }
+    }
+    const int batches = quick ? 10 : 100;
+    const unsigned long scale = quick ? 100 : 2000;
+
+    // Kontrolcünün ekrana yazdıkları (zaman aşımı mesajları) CSV'ye karışmasın.
+    std::ostringstream silent;
+    std::streambuf *saved_cout = std::cout.rdbuf(silent.rdbuf());
+
+    VirtualClock clock;
+    VirtualTimer modeTimer(clock), timeoutTimer(clock);
+    MockBackend backend;
+    JunctionOutput out(backend, default_pins());
+    out.init(0);
+    ModeRunner runner(out, clock, modeTimer, HEAD_COUNT);
+    Controller controller(out, runner, clock, timeoutTimer);
+    controller.start();
+    ReplyBuffer reply;
+    size_t sink = 0;
+    std::vector<BenchResult> results;
+
+    // Salt okunur komut karışımı; mod ve sıra değiştirmeyen komutlar.
+    static const char *const mix[] = {
+        "GETVERSION\r", "GETSIGNALGROUP\r", "GETMODE\r", "GETORDER\r", "GETMINSEQTIMEOUT\r",
+        "SETMINSEQTIMEOUT=40\r", "CPUVER\r", "GETERROR\r", "GETGPIOSTATS\r", "BOGUS\r",
+    };
+    const size_t n_mix = sizeof(mix) / sizeof(mix[0]);
+    results.push_back(run_case("dispatch_mix", batches, scale * 10, [&](unsigned long n) {
+        for (unsigned long i = 0; i < n; ++i) {
+            reply.clear();
+            controller.handle_line(mix[i % n_mix], reply);
+            sink += reply.size();
+        }
+    }));
+
+    results.push_back(run_case("parse_order", batches, scale * 50, [&](unsigned long n) {
+        int order[MAX_GROUPS];
+        for (unsigned long i = 0; i < n; ++i) sink += parse_order(i & 1 ? "t4-t3-t2-t1" : "t1-t2-t3-t4", order, HEAD_COUNT);
+    }));
+
+    results.push_back(run_case("getsignalgroup_format", batches, scale * 50, [&](unsigned long n) {
+        char text[SignalGroupFormatter::MAX_REPLY];
+        for (unsigned long i = 0; i < n; ++i) sink += controller.signalFormatter.format(OutputMask(i) & 0xfff, text);
+    }));
+
+    // Tam geçiş: iki plan adımı arasında gidip gelinir, her commit iki çipe yazar.
+    const OutputMask step_a = runner.sequencePlan.steps[0].outputs, step_b = runner.sequencePlan.steps[1].outputs;
+    {
+        MockBackend mb;
+        JunctionOutput o(mb, default_pins());
+        o.init(0);
+        results.push_back(run_case("commit_mock", batches, scale * 20, [&](unsigned long n) {
+            for (unsigned long i = 0; i < n; ++i) o.commit(i & 1 ? step_a : step_b);
+        }));
+    }
+    // SUBSCRIBE akışı: satır bir kez kodlanır, 8 abonenin kuyruğuna işaretçisi eklenir. Kuyruklar
+    // boşaltılmaz; dolduktan sonra yavaş abonenin birleştirme yolu ölçülür.
+    {
+        MockBackend mb;
+        JunctionOutput o(mb, default_pins());
+        o.init(0);
+        SignalStream stream(runner, controller.civil);
+        std::vector<std::unique_ptr<SubscriberQueue>> queues;
+        for (int i = 0; i < 8; ++i) {
+            queues.push_back(std::make_unique<SubscriberQueue>(stream.pool));
+            stream.subscribe(*queues.back(), 0);
+        }
+        o.add_observer(&stream);
+        results.push_back(run_case("commit_stream_8sub", batches, scale * 20, [&](unsigned long n) {
+            for (unsigned long i = 0; i < n; ++i) o.commit(i & 1 ? step_a : step_b);
+        }));
+        for (auto &q : queues) stream.unsubscribe(*q);
+    }
+    {
+        GpiodBackend gb;
+        JunctionOutput o(gb, default_pins());
+        if (o.init(0)) {        // gerçek libgpiod donanımsız makinede hat alamaz; satır atlanır
+            results.push_back(run_case("commit_gpiod", batches, scale * 20, [&](unsigned long n) {
+                for (unsigned long i = 0; i < n; ++i) o.commit(i & 1 ? step_a : step_b);
+            }));
+        }
+    }
+
+    // Mod değiştirme: komut satırından ilk adımın çıkışa yazılmasına kadar.
+    results.push_back(run_case("mode_switch", batches, scale, [&](unsigned long n) {
+        for (unsigned long i = 0; i < n; ++i) {
+            reply.clear();
+            controller.handle_line(i & 1 ? "SETMODE=SEQUENCE\r" : "SETMODE=FLASH\r", reply);
+        }
+    }));
+
+    // Zaman aşımı: PHASE modunda komut gelmez, zamanlayıcı dolar ve SEQUENCE'a geçilir.
+    controller.minseqtimeout = 1;
+    results.push_back(run_case("phase_timeout", batches, scale, [&](unsigned long n) {
+        for (unsigned long i = 0; i < n; ++i) {
+            controller.lastCommandTime = clock.now();
+            controller.switch_mode(Mode::PHASE);
+            clock.advance(std::chrono::seconds(1));
+            sink += runner.mode == Mode::SEQUENCE;
+        }
+    }));
+
+    std::cout.rdbuf(saved_cout);
+    std::printf("benchmark,ops,mean_ns,p50_ns,p99_ns\n");
+    for (const BenchResult &r : results) std::printf("%s,%lu,%.1f,%.1f,%.1f\n", r.name.c_str(), r.ops, r.mean_ns, r.p50_ns, r.p99_ns);
+
+    int status = sink == 0;
+    if (baseline) {
+        std::map<std::string, double> base = load_baseline(baseline);
+        if (base.empty()) {
+            std::fprintf(stderr, "Karşılaştırma dosyası okunamadı: %s\n", baseline);
+            return 1;
+        }
+        for (const BenchResult &r : results) {
+            auto it = base.find(r.name);
+            if (it == base.end() || r.mean_ns <= it->second * (1 + tolerance)) continue;
+            std::fprintf(stderr, "YAVAŞLAMA %s: %.1f ns -> %.1f ns (%+.0f%%)\n", r.name.c_str(), it->second, r.mean_ns,
+                         (r.mean_ns / it->second - 1) * 100);
+            status = 2;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <fcntl.h>
+#include <gpiod.h>
+#include <time.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "clock.h"
+#include "event_loop.h"
+#include "pin_map.h"
+
+// Yaklaşım başına duraklama çizgisi dedektörünün (endüktif döngü) anlık durumu. Kenarlar geldiği anda
+// işlenir; zamanlama motoru buradan boşluk (son aracın çıkışından beri geçen süre) ve doluluk okur.
+struct ApproachDetector {
+    bool occupied = false;
+    Clock::time_point last_on{};
+    Clock::time_point last_off{};
+    Clock::duration occupied_total{};   // döngünün dolu kaldığı toplam süre
+    unsigned long vehicles = 0;         // sayılan araç (birleştirilmiş yükselen kenar)
+    unsigned long edges = 0;            // ham kenar sayısı
+};
+
+class DetectorBank {
+public:
+    // Bu süreden kısa bir boşluktan sonra gelen yükselen kenar aynı araca sayılır (döngü titremesi).
+    static constexpr Clock::duration MERGE_GAP = std::chrono::milliseconds(100);
+
+    explicit DetectorBank(int approaches) : det(approaches) {}
+
+    void on_edge(int approach, bool rising, Clock::time_point t) {
+        if (approach < 0 || approach >= (int)det.size()) return;
+        ApproachDetector &d = det[approach];
+        ++d.edges;
+        if (rising == d.occupied) return;       // tekrarlanan kenar
+        d.occupied = rising;
+        if (rising) {
+            if (d.vehicles == 0 || t - d.last_off >= MERGE_GAP) ++d.vehicles;
+            d.last_on = t;
+        } else {
+            d.occupied_total += t - d.last_on;
+            d.last_off = t;
+        }
+    }
+
+    const ApproachDetector &operator[](int approach) const { return det[approach]; }
+    int size() const { return (int)det.size(); }
+
+    // Son aracın döngüden çıkışından beri geçen süre; döngü doluysa sıfır.
+    Clock::duration gap(int approach, Clock::time_point now) const {
+        const ApproachDetector &d = det[approach];
+        return d.occupied ? Clock::duration::zero() : now - d.last_off;
+    }
+
+private:
+    std::vector<ApproachDetector> det;
+};
+
+// Dedektör hatları giriş olarak, iki kenar olayıyla istenir. Her hattın olay fd'si olay döngüsüne eklenir;
+// hazır olduğunda olaylar toplu okunur ve çekirdeğin kenar zaman damgasıyla işlenir; böylece okumadaki
+// gecikme ölçümü bozmaz. gpiod v1 olaylarında damga çekirdek 5.7'den itibaren CLOCK_MONOTONIC, daha eski
+// çekirdeklerde (BeagleBone 4.x imajları) CLOCK_REALTIME'dır. Her toplu okumada iki saat de okunur ve
+// damga hangisine yakınsa o saatten monotona çevrilir; açılışta gerçek saat NTP ile sıçrasa da doğru
+// kalır. Bir uyanışta en fazla MAX_BATCHES toplu okuma yapılır; kalan olaylar bir sonraki turda okunur
+// ve zamanlayıcılar titreşen bir döngü yüzünden beklemez.
+class GpiodDetectorInput {
+public:
+    static constexpr unsigned BATCH = 16;
+    static constexpr int MAX_BATCHES = 4;
+
+    GpiodDetectorInput(EventLoop &loop, DetectorBank &bank) : loop(loop), bank(bank) {}
+    ~GpiodDetectorInput() {
+        for (auto &l : lines) {
+            loop.unwatch(l.fd);
+            gpiod_line_release(l.line);
+        }
+        for (gpiod_chip *c : chips) {
+            if (c) gpiod_chip_close(c);
+        }
+    }
+    GpiodDetectorInput(const GpiodDetectorInput &) = delete;
+    GpiodDetectorInput &operator=(const GpiodDetectorInput &) = delete;
+
+    bool add(const DetectorPin &pin) {
+        if (pin.chip >= (int)chips.size()) chips.resize(pin.chip + 1, nullptr);
+        if (!chips[pin.chip]) {
+            std::string name = "gpiochip" + std::to_string(pin.chip);
+            chips[pin.chip] = gpiod_chip_open_by_name(name.c_str());
+            if (!chips[pin.chip]) return false;
+        }
+        gpiod_line *line = gpiod_chip_get_line(chips[pin.chip], pin.offset);
+        if (!line || gpiod_line_request_both_edges_events(line, "led_control") != 0) return false;
+        int fd = gpiod_line_event_get_fd(line);
+        if (fd < 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+            gpiod_line_release(line);
+            return false;
+        }
+        int approach = pin.approach;
+        if (!loop.watch(fd, EPOLLIN, [this, fd, approach](uint32_t) { drain(fd, approach); })) {
+            gpiod_line_release(line);
+            return false;
+        }
+        lines.push_back({line, fd});
+        return true;
+    }
+
+    unsigned long events_read = 0;
+    unsigned long batches = 0;
+
+private:
+    void drain(int fd, int approach) {
+        gpiod_line_event events[BATCH];
+        for (int b = 0; b < MAX_BATCHES; ++b) {
+            int n = gpiod_line_event_read_fd_multiple(fd, events, BATCH);
+            if (n <= 0) break;      // EAGAIN: okunacak olay kalmadı
+            ++batches;
+            events_read += n;
+            timespec mono, real;
+            clock_gettime(CLOCK_MONOTONIC, &mono);
+            clock_gettime(CLOCK_REALTIME, &real);
+            for (int i = 0; i < n; ++i) {
+                bank.on_edge(approach, events[i].event_type == GPIOD_LINE_EVENT_RISING_EDGE, to_monotonic(events[i].ts, mono, real));
+            }
+            if (n < (int)BATCH) break;
+        }
+    }
+
+    static int64_t ns(const timespec &t) { return int64_t(t.tv_sec) * 1000000000 + t.tv_nsec; }
+
+    // Damga okuma anından (mono/real) önce olmalıdır; ileri düşen damga okuma anına çekilir.
+    static Clock::time_point to_monotonic(const timespec &ts, const timespec &mono, const timespec &real) {
+        int64_t t = ns(ts), m = ns(mono), r = ns(real);
+        int64_t age = std::llabs(m - t) <= std::llabs(r - t) ? m - t : r - t;
+        if (age < 0) age = 0;
+        return Clock::time_point(std::chrono::nanoseconds(m - age));
+    }
+
+    struct Line {
+        gpiod_line *line;
+        int fd;
+    };
+
+    EventLoop &loop;
+    DetectorBank &bank;
+    std::vector<gpiod_chip *> chips;
+    std::vector<Line> lines;
+};
@@ -0,0 +1,216 @@
+// Komut çözümleme mikro-ölçümü: eski if/else zinciri (std::string kopyaları, replace/erase, önek
+// karşılaştırmaları) ile tablo tabanlı dağıtıcıyı aynı komut karışımı ve aynı işleyicilerle
+// karşılaştırır. Saniyedeki komut sayısını ve komut başına heap tahsisini raporlar.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target dispatch_bench
+// Kullanım: dispatch_bench [tekrar]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "clock.h"
+#include "command_dispatch.h"
+#include "controller.h"
+#include "pin_map.h"
+
+static unsigned long allocations = 0;
+
+void *operator new(size_t size) {
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+static const char *const commands[] = {
+    "GETVERSION\\r", "GETSIGNALGROUP\r", "GETMODE\r", "GETORDER\r", "SETPHASEORDER=t4-t3-t2-t1\r",
+    "SETSEQORDER=t1-t2-t3-t4\r", "GETMINSEQTIMEOUT\r", "SETMINSEQTIMEOUT=40\r", "CPUVER\r", "GETERROR\r",
+    "SETMODE=FLASH\r", "SETMODE=SEQUENCE\r", "GETGPIOSTATS\r", "BOGUS\r",
+};
+
+// Eski main döngüsündeki sıra ayrıştırma ve GETORDER biçimlendirmesi, olduğu gibi (stringstream, vector).
+// Sıranın eski kopyası da tutulur; kontrolcüye tablo yolundaki set_order ile aynı durum değişikliği uygulanır.
+static std::vector<int> phaseOrder = {0, 1, 2, 3}, sequenceOrder = {0, 1, 2, 3};
+
+static std::vector<int> legacy_parse_order(const std::string &siraliKomut) {
+    std::stringstream ss(siraliKomut);
+    std::string parca;
+    std::vector<int> yeniSira;
+    bool kullanilanYonler[4] = {false};
+    while (std::getline(ss, parca, '-')) {
+        if (parca.length() == 2 && parca[0] == 't') {       // Her bir parçayı ("t1", "t2" vb.) kontrol et
+            char yonNo = parca[1];
+            if (yonNo >= '1' && yonNo <= '4') {
+                int index = yonNo - '1';
+                if (!kullanilanYonler[index]) {
+                    yeniSira.push_back(index);
+                    kullanilanYonler[index] = true;
+                } else {        // Hata: Aynı yön birden fazla kullanılmış
+                    yeniSira.clear();       // Hatalı durumu belirtmek için listeyi temizle
+                    break;
+                }
+            } else {        // Hata: 't5' gibi geçersiz bir yön
+                yeniSira.clear();
+                break;
+            }
+        } else {        // Hata: "t1" formatına uymayan bir parça
+            yeniSira.clear();
+            break;
+        }
+    }
+    return yeniSira;
+}
+
+static std::string format_order_vector(const std::vector<int> &order) {
+    std::stringstream ss;
+    for (size_t i = 0; i < order.size(); ++i) {
+        ss << "t" << (order[i] + 1);
+        if (i < order.size() - 1) {
+            ss << "-";
+        }
+    }
+    return ss.str();
+}
+
+static void legacy_set_order(Controller &c, Mode mode, const std::string &siraliKomut, ReplyBuffer &reply) {
+    std::vector<int> yeniSira = legacy_parse_order(siraliKomut);
+    bool is_phase = mode == Mode::PHASE;
+    if (yeniSira.size() != 4) {
+        reply.append(is_phase ? "Hatalı komut! Doğru format: SETPHASEORDER=t1-t2-t3-t4 (4 farklı ve geçerli yön kullanın)\n"
+                              : "Hatalı komut! Format: t1-t2-t3-t4 (4 farklı ve geçerli yön kullanın)\n");
+        return;
+    }
+    (is_phase ? phaseOrder : sequenceOrder) = yeniSira;
+    Clock::duration bound{};
+    bool swapped = c.runner.set_order(mode, yeniSira.data(), (int)yeniSira.size(), &bound);
+    reply.append(is_phase ? "Phase sırası güncellendi: " : "Sequence sırası güncellendi: ");
+    reply.append(siraliKomut);
+    reply.append('\n');
+    if (swapped) {
+        reply.append(is_phase ? "PHASE modu yeni sıraya kırmızı+sarı sonunda geçecek, en geç " : "SEQUENCE modu yeni sıraya kırmızı+sarı sonunda geçecek, en geç ");
+        reply.append_fixed(std::chrono::duration<double>(bound).count(), 1);
+        reply.append(" sn.\n");
+    } else {
+        reply.append(is_phase ? "Uyarı: Sistem PHASE modunda değil. Sıra kaydedildi ama şu anda uygulanamadı.\n"
+                              : "Uyarı: Sistem SEQUENCE modunda değil. Sıra kaydedildi ama şu anda uygulanamadı.\n");
+    }
+}
+
+// Eski main döngüsünün çözümleme kısmı: aynı string işlemleri, aynı karşılaştırma sırası, sıra komutlarında
+// aynı ayrıştırma. Diğer işleyiciler ve komut sonrası iş (zaman aşımı, durum kaydı, istatistik) tablo
+// yolundakilerle aynıdır; fark yalnızca komutun bulunması ve ayrıştırılmasıdır.
+static size_t legacy_handle(Controller &c, const char *line, ReplyBuffer &reply) {
+    const std::chrono::steady_clock::time_point arrived = std::chrono::steady_clock::now();
+    std::string komut = line;
+    size_t pos;
+    while ((pos = komut.find("\\r")) != std::string::npos) komut.replace(pos, 2, "\r");
+    komut.erase(std::remove(komut.begin(), komut.end(), '\r'), komut.end());
+    CommandSpec<Controller>::Handler handler = nullptr;
+    std::string arg;
+    bool handled = false;
+    auto set = [&](const char *prefix, CommandSpec<Controller>::Handler h) {
+        size_t n = std::char_traits<char>::length(prefix);
+        if (komut.rfind(prefix, 0) != 0) return false;
+        arg = komut.substr(n);
+        handler = h;
+        return true;
+    };
+    if (komut == "GETVERSION") handler = cmd_getversion;
+    else if (komut == "CPUVER") handler = cmd_cpuver;
+    else if (komut == "GETTIME") handler = cmd_gettime;
+    else if (set("SETTIME=", cmd_settime)) {}
+    else if (komut == "GETTIMEZONE") handler = cmd_gettimezone;
+    else if (set("SETTIMEZONE=", cmd_settimezone)) {}
+    else if (komut == "GETSIGNALGROUP") handler = cmd_getsignalgroup;
+    else if (komut.rfind("SETPHASEORDER=", 0) == 0) {
+        legacy_set_order(c, Mode::PHASE, komut.substr(14), reply);
+        handled = true;
+    } else if (komut.rfind("SETSEQORDER=", 0) == 0) {
+        legacy_set_order(c, Mode::SEQUENCE, komut.substr(12), reply);
+        handled = true;
+    } else if (komut == "GETORDER") {
+        std::string phase_str = format_order_vector(phaseOrder);
+        std::string seq_str = format_order_vector(sequenceOrder);
+        reply.append("Phase mode sirasi: ");
+        reply.append(phase_str);
+        reply.append("\nSequence mode sirasi: ");
+        reply.append(seq_str);
+        reply.append('\n');
+        handled = true;
+    }
+    else if (komut == "GETMINSEQTIMEOUT") handler = cmd_getminseqtimeout;
+    else if (set("SETMINSEQTIMEOUT=", cmd_setminseqtimeout)) {}
+    else if (komut == "GETMODE") handler = cmd_getmode;
+    else if (set("SETMODE=", cmd_setmode)) {}
+    else if (komut == "GETPLAN") handler = cmd_getplan;
+    else if (komut == "GETSCHEDULE") handler = cmd_getschedule;
+    else if (komut == "GETGPIOSTATS") handler = cmd_getgpiostats;
+    else if (komut == "GETSTATS") handler = cmd_getstats;
+    else if (komut == "GETERROR") handler = cmd_geterror;
+    else if (komut == "RESET") handler = cmd_reset;
+    else if (komut == "CLOSE") handler = cmd_close;
+    else if (komut == "INFO") handler = cmd_info;
+
+    c.requestTime = arrived;
+    c.lastCommandTime = c.clock.now();
+    if (handler) handler(c, arg, reply);
+    else if (!handled) reply.append("Bilinmeyen komut!\n");
+    c.rearm_timeout();
+    c.save_checkpoint();
+    c.command_time.record(std::chrono::steady_clock::now() - arrived);
+    c.publish_state();
+    return reply.size();
+}
+
+int main(int argc, char **argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const size_t n_cmds = sizeof(commands) / sizeof(commands[0]);
+
+    VirtualClock clock;
+    VirtualTimer modeTimer(clock), timeoutTimer(clock);
+    MockBackend backend;
+    JunctionOutput out(backend, default_pins());
+    out.init(0);
+    ModeRunner runner(out, clock, modeTimer, HEAD_COUNT);
+    Controller controller(out, runner, clock, timeoutTimer);
+    runner.start(Mode::SEQUENCE);
+    ReplyBuffer reply;
+
+    size_t sink = 0;
+    std::printf("path,commands,seconds,commands_per_second,allocations_per_command\n");
+
+    unsigned long a0 = allocations;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < n_cmds; ++i) {
+            reply.clear();
+            sink += legacy_handle(controller, commands[i], reply);
+        }
+    }
+    double legacy_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    unsigned long legacy_allocs = allocations - a0;
+
+    a0 = allocations;
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < n_cmds; ++i) {
+            reply.clear();
+            controller.handle_line(commands[i], reply);
+            sink += reply.size();
+        }
+    }
+    double table_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    unsigned long table_allocs = allocations - a0;
+
+    double total = double(rounds) * n_cmds;
+    std::printf("legacy_if_else,%.0f,%.3f,%.0f,%.2f\n", total, legacy_s, total / legacy_s, legacy_allocs / total);
+    std::printf("table_dispatch,%.0f,%.3f,%.0f,%.2f\n", total, table_s, total / table_s, table_allocs / total);
+    return sink == 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+#include "gpio_output.h"
+
+// Geçiş olay kaydı. Her ışık değişikliği ve mod değişikliği 32 baytlık sabit bir kayıt olarak,
+// bellek eşlemeli (mmap) bir dosyadaki halka tampona yazılır. Yazma birkaç bellek yazması ve
+// birkaç atomik store'dur; sistem çağrısı yoktur. Dosya MAP_SHARED olduğundan süreç çökse bile
+// kayıtlar çekirdek tarafından diske yazılır. Halka dolunca en eski kayıtların üzerine yazılır.
+
+enum EventType : uint8_t {
+    EVENT_SIGNAL = 1,       // head, old_state, new_state: kafa durumu (Signal)
+    EVENT_MODE = 2,         // old_state, new_state: mod (Mode)
+};
+
+struct EventRecord {
+    uint64_t time_ns;       // CLOCK_REALTIME, olay anı
+    uint64_t seq;           // kaydın sıra numarası (0'dan başlar, hiç sıfırlanmaz); yazılırken EVENT_SEQ_WRITING
+    uint8_t type;
+    uint8_t head;
+    uint8_t old_state;
+    uint8_t new_state;
+    uint8_t mode;           // olay anındaki aktif mod
+    uint8_t cause;          // CommitCause
+    uint8_t reserved[10];
+};
+static_assert(sizeof(EventRecord) == 32, "kayıt boyutu dosya biçiminin parçasıdır");
+
+struct EventLogHeader {
+    char magic[8];                  // "JCEVLOG1"
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;              // kayıt sayısı
+    std::atomic<uint64_t> head;     // yazılmış toplam kayıt sayısı
+    uint8_t reserved[32];
+};
+static_assert(sizeof(EventLogHeader) == 64, "başlık boyutu dosya biçiminin parçasıdır");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "head paylaşımlı bellekte kilitsiz olmalı");
+
+constexpr uint64_t EVENT_SEQ_WRITING = UINT64_MAX;
+
+constexpr char EVENT_LOG_MAGIC[8] = {'J', 'C', 'E', 'V', 'L', 'O', 'G', '1'};
+
+// Dosyayı eşler. Yazıcı için dosya yoksa ya da kapasite farklıysa yeniden oluşturulur; aynı
+// kapasiteyle var olan bir kayıt, yeniden başlatmadan sonra kaldığı yerden devam eder.
+class EventLogFile {
+public:
+    ~EventLogFile() { unmap(); }
+
+    bool open_writer(const char *path, uint64_t capacity) {
+        int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        size_t size = sizeof(EventLogHeader) + capacity * sizeof(EventRecord);
+        struct stat st;
+        bool reuse = fstat(fd, &st) == 0 && (size_t)st.st_size == size;
+        if (!reuse && ftruncate(fd, size) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        map = p;
+        map_size = size;
+        header = static_cast<EventLogHeader *>(p);
+        records = reinterpret_cast<EventRecord *>(header + 1);
+        if (!reuse || std::memcmp(header->magic, EVENT_LOG_MAGIC, 8) != 0 || header->capacity != capacity) {
+            std::memset(p, 0, size);
+            header->version = 1;
+            header->record_size = sizeof(EventRecord);
+            header->capacity = capacity;
+            header->head.store(0, std::memory_order_relaxed);
+            std::memcpy(header->magic, EVENT_LOG_MAGIC, 8);
+        }
+        return true;
+    }
+
+    bool open_reader(const char *path) {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(EventLogHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        map = p;
+        map_size = st.st_size;
+        header = static_cast<EventLogHeader *>(p);
+        records = reinterpret_cast<EventRecord *>(header + 1);
+        return std::memcmp(header->magic, EVENT_LOG_MAGIC, 8) == 0 && header->record_size == sizeof(EventRecord) &&
+               sizeof(EventLogHeader) + header->capacity * sizeof(EventRecord) <= map_size;
+    }
+
+    EventLogHeader *header = nullptr;
+    EventRecord *records = nullptr;
+
+private:
+    void unmap() {
+        if (map) munmap(map, map_size);
+        map = nullptr;
+    }
+    void *map = nullptr;
+    size_t map_size = 0;
+};
+
+// Tek yazıcılı halka. Her yuva kendi seq alanıyla seqlock gibi korunur: yazıcı üzerine yazmadan önce
+// seq'i EVENT_SEQ_WRITING yapar (release çiti), alanları yazar, seq'i release ile yeni sıraya getirir
+// ve head'i ilerletir. Okuyucu seq'i acquire ile okur, kaydı kopyalar ve acquire çitinden sonra seq'in
+// değişmediğini doğrular; bu arada üzerine yazılan kayıt böylece yarım kopya olarak kabul edilmez.
+class EventLog : public OutputObserver {
+public:
+    // Yalnızca ilk head_count kafa kaydedilir; üstteki bitler (durum LED'i) kayda girmez.
+    explicit EventLog(int head_count) : head_count(head_count) {}
+
+    bool open(const char *path, uint64_t capacity) {
+        if (capacity == 0 || !file.open_writer(path, capacity)) return false;
+        header = file.header;
+        records = file.records;
+        return true;
+    }
+
+    bool is_open() const { return header != nullptr; }
+
+    static uint64_t realtime_ns() {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);     // vDSO, sistem çağrısı yapmaz
+        return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    void push(uint8_t type, uint8_t head, uint8_t old_state, uint8_t new_state, uint8_t mode, uint8_t cause, uint64_t time_ns) {
+        if (!header) return;
+        uint64_t seq = header->head.load(std::memory_order_relaxed);
+        EventRecord &r = records[seq % header->capacity];
+        __atomic_store_n(&r.seq, EVENT_SEQ_WRITING, __ATOMIC_RELAXED);
+        std::atomic_thread_fence(std::memory_order_release);       // geçersiz seq, alanlardan önce görünür
+        r.time_ns = time_ns;
+        r.type = type;
+        r.head = head;
+        r.old_state = old_state;
+        r.new_state = new_state;
+        r.mode = mode;
+        r.cause = cause;
+        __atomic_store_n(&r.seq, seq, __ATOMIC_RELEASE);
+        header->head.store(seq + 1, std::memory_order_release);
+    }
+
+    void on_commit(OutputMask prev, OutputMask next, uint8_t mode, uint8_t cause) override {
+        record(prev, next, mode, cause, realtime_ns());
+    }
+
+    // Değişen her kafa için bir kayıt; mod değiştiyse önce mod kaydı yazılır. --rt ile geçiş zamanlama
+    // tarafında zaman damgasıyla alınır ve kayıt ana döngüde yazılır (EventLogRelay).
+    void record(OutputMask prev, OutputMask next, uint8_t mode, uint8_t cause, uint64_t time_ns) {
+        if (mode != last_mode) {
+            push(EVENT_MODE, 0, last_mode, mode, mode, cause, time_ns);
+            last_mode = mode;
+        }
+        OutputMask changed = prev ^ next;
+        for (int h = 0; h < head_count; ++h) {
+            if (get_head(changed, h)) push(EVENT_SIGNAL, (uint8_t)h, get_head(prev, h), get_head(next, h), mode, cause, time_ns);
+        }
+    }
+
+private:
+    EventLogFile file;
+    EventLogHeader *header = nullptr;
+    EventRecord *records = nullptr;
+    int head_count;
+    uint8_t last_mode = 0;
+};
+
+// Kayıt dosyasının okuyucusu. Halkada hâlâ duran en eski kayıttan başlar.
+class EventLogReader {
+public:
+    bool open(const char *path) { return file.open_reader(path); }
+
+    uint64_t capacity() const { return file.header->capacity; }
+    uint64_t head() const { return file.header->head.load(std::memory_order_acquire); }
+    uint64_t oldest() const {
+        uint64_t h = head();
+        return h > capacity() ? h - capacity() : 0;
+    }
+
+    // seq numaralı kaydı kopyalar; kayıt artık halkada değilse false döner.
+    bool read(uint64_t seq, EventRecord &out) const {
+        if (seq >= head()) return false;
+        const EventRecord &r = file.records[seq % capacity()];
+        if (__atomic_load_n(&r.seq, __ATOMIC_ACQUIRE) != seq) return false;
+        std::memcpy(&out, &r, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);       // kopya, ikinci seq okumasından önce biter
+        return __atomic_load_n(&r.seq, __ATOMIC_RELAXED) == seq;
+    }
+
+    // Zaman sırasıyla yazıldıkları için ikili arama ile time_ns'den büyük ya da eşit ilk kayıt bulunur.
+    uint64_t lower_bound(uint64_t time_ns) const {
+        uint64_t lo = oldest(), hi = head();
+        while (lo < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            EventRecord r;
+            if (!read(mid, r) || r.time_ns < time_ns) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+private:
+    EventLogFile file;
+};
@@ -0,0 +1,108 @@
+// Geçiş olay kaydı çözücüsü. Bellek eşlemeli kayıt dosyasını okur; zaman aralığı ikili aramayla
+// bulunduğundan milyonlarca kayıt arasından bir aralık anında süzülür.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target event_log_dump
+// Kullanım: event_log_dump DOSYA [--from "YYYY-mm-dd HH:MM:SS"] [--to "..."] [--head N] [--mode-only]
+//                         [--csv] [--count] [--follow]
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include "event_log.h"
+#include "signal_modes.h"
+
+// "YYYY-mm-dd HH:MM:SS" (yerel saat) ya da epoch saniyesi kabul edilir.
+static bool parse_time(const char *s, uint64_t &ns) {
+    std::tm t = {};
+    const char *end = strptime(s, "%Y-%m-%d %H:%M:%S", &t);
+    if (end && *end == '\0') {
+        t.tm_isdst = -1;
+        ns = uint64_t(std::mktime(&t)) * 1000000000;
+        return true;
+    }
+    char *e;
+    double sec = std::strtod(s, &e);
+    if (*e != '\0') return false;
+    ns = uint64_t(sec * 1e9);
+    return true;
+}
+
+static void print_record(const EventRecord &r, bool csv) {
+    time_t sec = time_t(r.time_ns / 1000000000);
+    std::tm tm;
+    localtime_r(&sec, &tm);
+    char when[32];
+    std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+    unsigned ms = unsigned(r.time_ns / 1000000 % 1000);
+    const char *mode = mode_name((Mode)r.mode);
+    if (r.type == EVENT_MODE) {
+        const char *from = mode_name((Mode)r.old_state), *to = mode_name((Mode)r.new_state);
+        if (csv) std::printf("%llu,%s.%03u,MODE,,%s,%s,%s,%s\n", (unsigned long long)r.seq, when, ms, from, to, mode, cause_name(r.cause));
+        else std::printf("%s.%03u #%llu MODE %s -> %s (%s)\n", when, ms, (unsigned long long)r.seq, from, to, cause_name(r.cause));
+        return;
+    }
+    const char *from = signal_name(r.old_state), *to = signal_name(r.new_state);
+    if (csv) std::printf("%llu,%s.%03u,SIGNAL,t%u,%s,%s,%s,%s\n", (unsigned long long)r.seq, when, ms, r.head + 1, from, to, mode, cause_name(r.cause));
+    else std::printf("%s.%03u #%llu t%u %s -> %s mode=%s (%s)\n", when, ms, (unsigned long long)r.seq, r.head + 1, from, to, mode, cause_name(r.cause));
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Kullanım: %s DOSYA [--from ZAMAN] [--to ZAMAN] [--head N] [--mode-only] [--csv] [--count] [--follow]\n", argv[0]);
+        return 1;
+    }
+    uint64_t from = 0, to = UINT64_MAX;
+    int head = -1;
+    bool mode_only = false, csv = false, count_only = false, follow = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--from" && i + 1 < argc) {
+            if (!parse_time(argv[++i], from)) return std::fprintf(stderr, "Geçersiz zaman: %s\n", argv[i]), 1;
+        } else if (a == "--to" && i + 1 < argc) {
+            if (!parse_time(argv[++i], to)) return std::fprintf(stderr, "Geçersiz zaman: %s\n", argv[i]), 1;
+        } else if (a == "--head" && i + 1 < argc) head = std::atoi(argv[++i]) - 1;
+        else if (a == "--mode-only") mode_only = true;
+        else if (a == "--csv") csv = true;
+        else if (a == "--count") count_only = true;
+        else if (a == "--follow") follow = true;
+        else return std::fprintf(stderr, "Bilinmeyen seçenek: %s\n", a.c_str()), 1;
+    }
+
+    EventLogReader reader;
+    if (!reader.open(argv[1])) {
+        std::fprintf(stderr, "Kayıt dosyası açılamadı ya da geçersiz: %s\n", argv[1]);
+        return 1;
+    }
+    static char outbuf[1 << 16];
+    std::setvbuf(stdout, outbuf, _IOFBF, sizeof(outbuf));
+    if (csv && !count_only) std::printf("seq,time,type,head,from,to,mode,cause\n");
+
+    unsigned long matched = 0, lost = 0;
+    uint64_t seq = from ? reader.lower_bound(from) : reader.oldest();
+    while (true) {
+        for (; seq < reader.head(); ++seq) {
+            EventRecord r;
+            if (!reader.read(seq, r)) {     // okunurken üzerine yazıldı
+                ++lost;
+                if (seq < reader.oldest()) seq = reader.oldest() - 1;
+                continue;
+            }
+            if (r.time_ns > to) break;
+            if (mode_only && r.type != EVENT_MODE) continue;
+            if (head >= 0 && (r.type != EVENT_SIGNAL || r.head != head)) continue;
+            ++matched;
+            if (!count_only) print_record(r, csv);
+        }
+        if (!follow || seq < reader.head()) break;
+        std::fflush(stdout);
+        usleep(100000);
+    }
+    if (count_only) std::printf("%lu\n", matched);
+    std::fflush(stdout);
+    if (lost) std::fprintf(stderr, "%lu kayıt okunurken üzerine yazıldı\n", lost);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "clock.h"
+
+// Tek iş parçacıklı epoll döngüsü. Komut girişi, mod zamanlayıcısı ve zaman aşımı aynı döngüden yürür;
+// süreç yalnızca bir fd hazır olduğunda ya da bir zamanlayıcı dolduğunda uyanır.
+class EventLoop {
+public:
+    using Handler = std::function<void(uint32_t events)>;
+
+    EventLoop() : epfd(epoll_create1(EPOLL_CLOEXEC)) {}
+    ~EventLoop() { close(epfd); }
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    bool watch(int fd, uint32_t events, Handler handler) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) return false;
+        dead.erase(std::remove(dead.begin(), dead.end(), fd), dead.end());
+        handlers[fd] = std::move(handler);
+        return true;
+    }
+
+    bool modify(int fd, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        return epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev) == 0;
+    }
+
+    // Çalışan bir işleyici kendini silebilir; silme işlemi olay grubu bitince yapılır.
+    void unwatch(int fd) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        dead.push_back(fd);
+    }
+
+    // Olay grubundaki işleyicilerden sonra çalışacak iş. Zaman kritik yoldaki kod (geçiş) yalnızca işi
+    // sıraya koyar; soket yazmaları gibi uzun işler aynı uyanışta, zamanlayıcı işlendikten sonra yapılır.
+    void defer(std::function<void()> task) { deferred.push_back(std::move(task)); }
+
+    void run() {
+        running = true;
+        epoll_event events[32];
+        while (running) {
+            int n = epoll_wait(epfd, events, 32, -1);
+            for (int i = 0; i < n && running; ++i) {
+                int fd = events[i].data.fd;
+                if (std::find(dead.begin(), dead.end(), fd) != dead.end()) continue;
+                auto it = handlers.find(fd);
+                if (it != handlers.end()) it->second(events[i].events);
+            }
+            while (!deferred.empty()) {     // iş yeni iş ekleyebilir
+                draining.swap(deferred);
+                for (auto &task : draining) task();
+                draining.clear();
+            }
+            for (int fd : dead) handlers.erase(fd);
+            dead.clear();
+        }
+    }
+
+    void stop() { running = false; }
+
+private:
+    int epfd;
+    bool running = false;
+    std::unordered_map<int, Handler> handlers;
+    std::vector<int> dead;
+    std::vector<std::function<void()>> deferred, draining;
+};
+
+// timerfd tabanlı zamanlayıcı. Mutlak CLOCK_MONOTONIC (steady_clock) zamanına kurulur,
+// böylece geçişler döngü yükü kadar kaymaz.
+class Timer : public DeadlineTimer {
+public:
+    explicit Timer(EventLoop &loop, std::function<void()> on_expire = nullptr)
+        : loop(loop), fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {
+        this->on_expire(std::move(on_expire));
+        loop.watch(fd, EPOLLIN, [this](uint32_t) {
+            uint64_t expirations;
+            if (read(this->fd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+            is_armed = false;
+            fire();
+        });
+    }
+
+    ~Timer() override {
+        loop.unwatch(fd);
+        close(fd);
+    }
+
+    void arm_at(Clock::time_point deadline) override {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        if (ns <= 0) ns = 1;        // 0 zamanlayıcıyı kapatır
+        itimerspec spec{};
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+        timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+        is_armed = true;
+    }
+
+    void disarm() override {
+        itimerspec spec{};
+        timerfd_settime(fd, 0, &spec, nullptr);
+        is_armed = false;
+    }
+
+    bool armed() const { return is_armed; }
+
+private:
+    EventLoop &loop;
+    int fd;
+    bool is_armed = false;
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <gpiod.h>      // libgpiod library
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "conflict_monitor.h"
+#include "latency_histogram.h"
+#include "output_mask.h"
+#include "signal_snapshot.h"
+
+// Bir çıkış değişikliğinin sebebi. Olay kaydı ve izleme araçları için geçişle birlikte taşınır.
+enum CommitCause : uint8_t {
+    CAUSE_STARTUP = 0,
+    CAUSE_STEP = 1,             // modun bir sonraki adımı
+    CAUSE_MODE_CHANGE = 2,      // komutla mod değişimi
+    CAUSE_COMMAND = 3,          // diğer komutlar (sıra değişikliği, RESET, CLOSE)
+    CAUSE_TIMEOUT = 4,          // PHASE zaman aşımı
+    CAUSE_SHUTDOWN = 5,
+    CAUSE_CONFLICT = 6,         // çakışma denetimi reddetti, FLASH'a geçildi
+    CAUSE_SCHEDULE = 7,         // zaman çizelgesiyle mod değişimi
+};
+
+inline const char *cause_name(uint8_t cause) {
+    switch (cause) {
+        case CAUSE_STARTUP: return "STARTUP";
+        case CAUSE_STEP: return "STEP";
+        case CAUSE_MODE_CHANGE: return "MODE_CHANGE";
+        case CAUSE_COMMAND: return "COMMAND";
+        case CAUSE_TIMEOUT: return "TIMEOUT";
+        case CAUSE_SHUTDOWN: return "SHUTDOWN";
+        case CAUSE_CONFLICT: return "CONFLICT";
+        case CAUSE_SCHEDULE: return "SCHEDULE";
+        default: return "?";
+    }
+}
+
+// Her commit'ten sonra çağrılır. Gözlemciler zaman kritik yolda çalışır, kısa ve kilitsiz olmalıdır.
+class OutputObserver {
+public:
+    virtual ~OutputObserver() = default;
+    virtual void on_commit(OutputMask prev, OutputMask next, uint8_t mode, uint8_t cause) = 0;
+};
+
+struct OutputPin {
+    int chip;       // gpiochipN
+    int offset;     // çip üzerindeki hat numarası
+};
+
+// Donanım erişimi bu arayüzün arkasındadır. set_bulk() bir çipin bütün hatlarını tek çağrıda yazar.
+class OutputBackend {
+public:
+    virtual ~OutputBackend() = default;
+    virtual bool request(int chip, const std::vector<int> &offsets, const std::vector<int> &initial) = 0;
+    virtual void set_bulk(int chip, const int *values, unsigned count) = 0;
+};
+
+class GpiodBackend : public OutputBackend {
+public:
+    ~GpiodBackend() override {
+        for (auto &c : chips) {
+            if (c.bulk.num_lines) gpiod_line_release_bulk(&c.bulk);
+            if (c.chip) gpiod_chip_close(c.chip);
+        }
+    }
+
+    bool request(int chip, const std::vector<int> &offsets, const std::vector<int> &initial) override {
+        if (chip >= (int)chips.size()) chips.resize(chip + 1);
+        Chip &c = chips[chip];
+        std::string name = "gpiochip" + std::to_string(chip);
+        c.chip = gpiod_chip_open_by_name(name.c_str());
+        if (!c.chip || offsets.size() > GPIOD_LINE_BULK_MAX_LINES) return false;
+        gpiod_line_bulk_init(&c.bulk);
+        for (int off : offsets) {
+            gpiod_line *line = gpiod_chip_get_line(c.chip, off);
+            if (!line) return false;
+            gpiod_line_bulk_add(&c.bulk, line);
+        }
+        return gpiod_line_request_bulk_output(&c.bulk, "led_control", initial.data()) == 0;
+    }
+
+    void set_bulk(int chip, const int *values, unsigned count) override {
+        (void)count;
+        gpiod_line_set_value_bulk(&chips[chip].bulk, values);   // tek ioctl
+    }
+
+private:
+    struct Chip {
+        gpiod_chip *chip = nullptr;
+        gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+    };
+    std::vector<Chip> chips;
+};
+
+// Donanımsız çalışma için sahte arka uç. Her toplu yazma bir "syscall" olarak sayılır.
+class MockBackend : public OutputBackend {
+public:
+    bool request(int chip, const std::vector<int> &offsets, const std::vector<int> &initial) override {
+        if (chip >= (int)values.size()) values.resize(chip + 1);
+        values[chip] = initial;
+        (void)offsets;
+        return true;
+    }
+
+    void set_bulk(int chip, const int *vals, unsigned count) override {
+        values[chip].assign(vals, vals + count);
+        ++calls;
+    }
+
+    std::vector<std::vector<int>> values;   // çip başına son yazılan değerler
+    unsigned long calls = 0;
+};
+
+// Hatları çip bazında gruplar ve bir sonraki kavşak durumunu tek maske olarak uygular.
+// Değişen her çip için tam olarak bir toplu yazma yapılır, aradaki ara durumlar görünmez.
+class JunctionOutput {
+public:
+    JunctionOutput(OutputBackend &backend, const std::vector<OutputPin> &pins) : backend(backend) {
+        for (int bit = 0; bit < (int)pins.size(); ++bit) {
+            ChipGroup *group = nullptr;
+            for (auto &g : groups) {
+                if (g.chip == pins[bit].chip) group = &g;
+            }
+            if (!group) {
+                groups.emplace_back(pins[bit].chip);
+                group = &groups.back();
+            }
+            group->offsets.push_back(pins[bit].offset);
+            group->bits.push_back(bit);
+            group->mask |= OutputMask(1) << bit;
+        }
+    }
+
+    bool init(OutputMask initial) {
+        for (auto &g : groups) {
+            g.values.resize(g.bits.size());
+            fill_values(g, initial);
+            if (!backend.request(g.chip, g.offsets, g.values)) return false;
+        }
+        current = initial;
+        snapshot.publish(initial);
+        return true;
+    }
+
+    // Çakışma denetimi varsa çıkış yazılmadan önce denetlenir; reddedilen çıkış yazılmaz ve false döner.
+    bool commit(OutputMask next, uint8_t cause = CAUSE_STEP) {
+        if (monitor && !monitor->admit(next)) return false;
+        OutputMask prev = current.load(std::memory_order_relaxed);
+        OutputMask changed = prev ^ next;
+        unsigned calls = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto &g : groups) {
+            if (!(changed & g.mask)) continue;      // bu çipte değişiklik yok
+            fill_values(g, next);
+            backend.set_bulk(g.chip, g.values.data(), (unsigned)g.values.size());
+            ++calls;
+        }
+        if (calls) commit_time.record(std::chrono::steady_clock::now() - t0);
+        current.store(next, std::memory_order_release);
+        snapshot.publish(next);
+        last_syscalls = calls;
+        total_syscalls += calls;
+        ++transitions;
+        for (OutputObserver *o : observers) o->on_commit(prev, next, mode_tag, cause);
+        return true;
+    }
+
+    void add_observer(OutputObserver *o) { observers.push_back(o); }
+
+    OutputMask state() const { return current.load(std::memory_order_acquire); }
+
+    int pin_count() const {
+        int n = 0;
+        for (const auto &g : groups) n += (int)g.bits.size();
+        return n;
+    }
+
+    SignalSnapshot snapshot;                // okuyucular için sürümlü, kilitsiz durum
+    ConflictMonitor *monitor = nullptr;     // verilirse her commit GPIO'dan önce denetlenir
+    uint8_t mode_tag = 0;                   // aktif mod (Mode), gözlemcilere iletilir
+    unsigned last_syscalls = 0;             // son geçişte yapılan toplu yazma sayısı
+    unsigned long total_syscalls = 0;
+    unsigned long transitions = 0;
+    LatencyHistogram commit_time;           // toplu GPIO yazmalarının süresi
+
+private:
+    struct ChipGroup {
+        explicit ChipGroup(int chip) : chip(chip) {}
+        int chip;
+        std::vector<int> offsets;
+        std::vector<int> bits;      // her hattın maskedeki bit numarası
+        std::vector<int> values;
+        OutputMask mask = 0;
+    };
+
+    static void fill_values(ChipGroup &g, OutputMask mask) {
+        for (size_t i = 0; i < g.bits.size(); ++i) {
+            g.values[i] = (mask >> g.bits[i]) & 1;
+        }
+    }
+
+    OutputBackend &backend;
+    std::vector<ChipGroup> groups;
+    std::vector<OutputObserver *> observers;
+    std::atomic<OutputMask> current{0};
+};
@@ -0,0 +1,219 @@
+// Kararlı durumda heap kullanılmadığını doğrular. Kontrolcü sanal saatle ve sahte GPIO arka ucuyla
+// junction_control'daki gibi kurulur (plan dosyası, zaman çizelgesi, dedektörle uzayan yeşiller,
+// olay kaydı, durum kaydı, /dev/shm segmenti, protokol izi, biri yavaş iki SUBSCRIBE abonesi). Bir
+// ısınma turundan sonra heap_guard mühürlenir; ardından bütün komutlar ve bir günü aşan geçişler
+// birkaç tur çalıştırılır. Her işlemin mühürden sonraki ayırma sayısı CSV olarak yazılır; herhangi
+// bir ayırma varsa çıkış kodu 1'dir. --backtrace ile her ayırmanın çağrı yığını standart hataya yazılır.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target heap_audit
+// Kullanım: heap_audit [--plans plans.conf] [--passes 3] [--backtrace] > heap.csv
+
+#include <execinfo.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "heap_guard.h"
+
+#include "actuated_timing.h"
+#include "clock.h"
+#include "controller.h"
+#include "detector_input.h"
+#include "event_log.h"
+#include "gpio_output.h"
+#include "mode_runner.h"
+#include "pin_map.h"
+#include "protocol_trace.h"
+#include "shm_state.h"
+#include "signal_stream.h"
+#include "state_checkpoint.h"
+#include "time_schedule.h"
+
+static bool print_backtrace = false;
+static const char *current_op = "";
+
+// Ayırma anında çağrılır; bellek ayırmadan yazar.
+static void on_allocation(size_t) {
+    if (!print_backtrace) return;
+    char head[160];
+    int n = std::snprintf(head, sizeof(head), "--- %s\n", current_op);
+    ssize_t w = write(STDERR_FILENO, head, n > 0 ? size_t(n) : 0);
+    (void)w;
+    void *frames[24];
+    int k = backtrace(frames, 24);
+    backtrace_symbols_fd(frames, k, STDERR_FILENO);
+}
+
+struct OpResult {
+    std::string name;
+    unsigned long runs = 0;
+    unsigned long allocations = 0;
+};
+
+int main(int argc, char **argv) {
+    const char *plan_file = nullptr;
+    int passes = 3;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--plans") == 0 && i + 1 < argc) plan_file = argv[++i];
+        else if (std::strcmp(argv[i], "--passes") == 0 && i + 1 < argc) passes = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--backtrace") == 0) print_backtrace = true;
+        else {
+            std::fprintf(stderr, "Kullanım: %s [--plans plans.conf] [--passes 3] [--backtrace]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Kontrolcünün ekrana yazdıkları (zaman aşımı mesajları) CSV'ye karışmasın. Akış ısınmada büyür,
+    // sonra her tur başında boşaltılır.
+    std::ostringstream silent;
+    std::cout.rdbuf(silent.rdbuf());
+
+    char dir[] = "/tmp/heap_audit.XXXXXX";
+    if (!mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    const std::string base = dir;
+    const std::string shm_name = "/heap_audit." + std::to_string(getpid());
+
+    VirtualClock clock;
+    VirtualTimer modeTimer(clock), timeoutTimer(clock), scheduleTimer(clock);
+    MockBackend backend;
+    EventLog eventLog(HEAD_COUNT);
+    JunctionOutput out(backend, default_pins());
+    if (!eventLog.open((base + "/events").c_str(), 4096)) {
+        std::fprintf(stderr, "olay kaydı açılamadı\n");
+        return 1;
+    }
+    out.add_observer(&eventLog);
+    out.init(0);
+    ModeRunner runner(out, clock, modeTimer, HEAD_COUNT);
+    ConflictRules rules(HEAD_COUNT, 3000);
+    TimeSchedule schedule;
+    if (plan_file) {
+        std::string error;
+        if (!load_plan_file(plan_file, runner.plans, error, &rules, &schedule)) {
+            std::fprintf(stderr, "Plan dosyası hatalı: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    ConflictMonitor monitor(rules, &clock);
+    out.monitor = &monitor;
+    DetectorBank detectors(HEAD_COUNT);
+    ActuatedTiming timing{detectors};
+    runner.actuation = &timing;
+
+    Controller controller(out, runner, clock, timeoutTimer);
+    ModeScheduler scheduler(schedule, controller.civil, clock, scheduleTimer);
+    if (!schedule.empty()) {
+        std::string error;
+        if (!controller.attach_schedule(schedule, scheduler, error)) {
+            std::fprintf(stderr, "Zaman çizelgesi hatalı: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    StateCheckpoint checkpoint;
+    ShmStateWriter shm;
+    ProtocolTraceWriter trace;
+    if (!checkpoint.open((base + "/state").c_str()) || !shm.open(shm_name.c_str()) || !trace.open((base + "/trace").c_str())) {
+        std::fprintf(stderr, "durum kaydı, /dev/shm segmenti ya da iz dosyası açılamadı\n");
+        return 1;
+    }
+    controller.checkpoint = &checkpoint;
+    controller.shm = &shm;
+    controller.trace = &trace;
+
+    SignalStream stream(runner, controller.civil);
+    stream.pool.reserve(2 * SubscriberQueue::CAPACITY + 1);
+    out.add_observer(&stream);
+    SubscriberQueue fast(stream.pool), slow(stream.pool);   // slow hiç boşaltılmaz
+    stream.subscribe(fast, out.state());
+    stream.subscribe(slow, out.state());
+    controller.start();
+
+    // İşlemler: bütün komutlar, yüklenen planlar ve sanal zamanda geçişler.
+    std::vector<std::string> commands;
+    for (const auto &spec : controller_command_specs) {
+        if (!spec.takes_arg) commands.push_back(std::string(spec.name));
+    }
+    for (const char *c : {"SETTIME=2026-03-02 06:55:00", "SETTIMEZONE=UTC+3", "SETPHASEORDER=t4-t3-t2-t1",
+                          "SETSEQORDER=t2-t1-t3-t4", "SETMINSEQTIMEOUT=40", "SETMODE=PHASE", "SETPHASEORDER=t1-t2-t3-t4",
+                          "SETMODE=SEQUENCE", "SETSEQORDER=t1-t2-t3-t4", "SETMODE=FLASH", "SETMODE=BOGUS", "SETTIME=bozuk"}) {
+        commands.push_back(c);
+    }
+    for (const SignalPlan &p : runner.plans) commands.push_back("SETMODE=" + std::string(p.name));
+    commands.push_back("BOGUS");
+    commands.push_back("RESET");
+
+    std::vector<OpResult> results;
+    for (const std::string &c : commands) results.push_back({c});
+    results.push_back({"transitions_26h"});
+    results.push_back({"detector_demand"});
+    results.push_back({"stream_drain"});
+    results.push_back({"publish_state"});
+    results.push_back({"trace_flush"});
+
+    ReplyBuffer reply;
+    auto run_pass = [&](bool counted) {
+        size_t r = 0;
+        auto measure = [&](const char *name, auto &&body) {
+            current_op = name;
+            unsigned long before = heap_guard::after_seal.load();
+            body();
+            if (counted) {
+                results[r].runs++;
+                results[r].allocations += heap_guard::after_seal.load() - before;
+            }
+            ++r;
+        };
+        for (const std::string &c : commands) {
+            measure(c.c_str(), [&] {
+                reply.clear();
+                controller.handle_line(c, reply, TRACE_SOURCE_SERIAL);
+            });
+        }
+        measure("transitions_26h", [&] {
+            for (int m = 0; m < 26 * 60; ++m) clock.advance(std::chrono::minutes(1));
+        });
+        measure("detector_demand", [&] {
+            for (int s = 0; s < 120; ++s) {
+                for (int a = 0; a < HEAD_COUNT; ++a) detectors.on_edge(a, s & 1, clock.now());
+                clock.advance(std::chrono::seconds(1));
+            }
+        });
+        measure("stream_drain", [&] { fast.consume(SIZE_MAX); });
+        measure("publish_state", [&] { controller.publish_state(); });
+        measure("trace_flush", [&] { trace.flush(); });
+        silent.seekp(0);
+    };
+
+    void *warm[4];
+    backtrace(warm, 4);     // libgcc ilk çağrıda yüklenir; mühürden önce
+    run_pass(false);
+    heap_guard::on_violation = on_allocation;
+    heap_guard::seal();
+    for (int p = 0; p < passes; ++p) run_pass(true);
+    heap_guard::unseal();
+
+    stream.unsubscribe(fast);
+    stream.unsubscribe(slow);
+    shm_unlink(shm_name.c_str());
+    for (const char *f : {"/events", "/state", "/trace"}) unlink((base + f).c_str());
+    rmdir(dir);
+
+    unsigned long total = 0;
+    std::printf("operation,runs,allocations\n");
+    for (const OpResult &r : results) {
+        std::printf("\"%s\",%lu,%lu\n", r.name.c_str(), r.runs, r.allocations);
+        total += r.allocations;
+    }
+    std::printf("total,%d,%lu\n", passes, total);
+    if (total) std::fprintf(stderr, "Mühürden sonra %lu bellek ayırması\n", total);
+    return total ? 1 : 0;
+}
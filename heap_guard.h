@@ -0,0 +1,88 @@
+#pragma once
+
+#include <unistd.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Başlangıçtan sonra heap kullanımını yakalar. Kurulum (plan dosyası, pin haritası, soketler) bittikten
+// sonra seal() çağrılır; o andan sonraki her operator new sayılır ve on_violation çağrılır. Kararlı
+// durumda komut ve geçiş yolları bellek ayırmaz: planlar ve sıralar sabit kaplarda (inline_storage.h),
+// plan sürümleri PlanVersionPool'da, yanıtlar ReplyBuffer'da, akış çerçeveleri FramePool'da durur.
+// Bağlantı kurulumu (accept, SUBSCRIBE) istemci başına bir kez bellek ayırır; bu yol kapsam dışıdır.
+//
+// Sayaçlar her zaman vardır. Global operator new/delete yalnızca JUNCTION_HEAP_GUARD tanımlıyken
+// değiştirilir ve bu başlık programda tek bir çeviri biriminden (main'in bulunduğu) include edilir.
+namespace heap_guard {
+
+inline std::atomic<bool> sealed{false};
+inline std::atomic<unsigned long> allocations{0};       // bütün operator new çağrıları
+inline std::atomic<unsigned long> after_seal{0};        // seal()'dan sonrakiler
+inline thread_local bool reporting = false;
+
+// Mühürden sonraki ayırmada, ayırmadan önce çağrılır (boyut ile). İçinde bellek ayırmak yeniden
+// çağrılmaya yol açmaz ama sayılır; yazma için write(2) gibi ayırmayan çağrılar kullanılmalıdır.
+inline void (*on_violation)(size_t size) = nullptr;
+
+inline void seal() { sealed.store(true, std::memory_order_release); }
+inline void unseal() { sealed.store(false, std::memory_order_release); }
+
+inline void note(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (!sealed.load(std::memory_order_relaxed)) return;
+    after_seal.fetch_add(1, std::memory_order_relaxed);
+    if (on_violation && !reporting) {
+        reporting = true;
+        on_violation(size);
+        reporting = false;
+    }
+}
+
+// Varsayılan bildirim: ilk ayırma standart hataya tek satırla yazılır.
+inline void report_first(size_t) {
+    static std::atomic<bool> reported{false};
+    if (reported.exchange(true)) return;
+    static const char msg[] = "heap_guard: başlangıçtan sonra bellek ayrıldı\n";
+    ssize_t n = ::write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    (void)n;
+}
+
+inline void *allocate(size_t size) {
+    note(size);
+    void *p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+inline void *allocate_aligned(size_t size, std::align_val_t align) {
+    note(size);
+    size_t a = static_cast<size_t>(align);
+    void *p = std::aligned_alloc(a, (size + a - 1) / a * a);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+}   // namespace heap_guard
+
+#ifdef JUNCTION_HEAP_GUARD
+void *operator new(size_t size) { return heap_guard::allocate(size); }
+void *operator new[](size_t size) { return heap_guard::allocate(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    heap_guard::note(size);
+    return std::malloc(size ? size : 1);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    heap_guard::note(size);
+    return std::malloc(size ? size : 1);
+}
+void *operator new(size_t size, std::align_val_t align) { return heap_guard::allocate_aligned(size, align); }
+void *operator new[](size_t size, std::align_val_t align) { return heap_guard::allocate_aligned(size, align); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+
+// Yığıt ya da nesne içinde duran sabit kapasiteli kaplar. Plan tabloları, sıralar ve plan adları
+// bunlarla tutulur: kopyalamak ve yeniden derlemek bellek ayırmaz, kararlı durumda komut ve geçiş
+// yolu heap'e dokunmaz (bkz. heap_guard.h). Kapasite aşılırsa eleman eklenmez; sınırlar yükleme
+// sırasında denetlenir (load_plan_file), çalışma sırasında taşma olmaz.
+
+template <typename T, size_t N>
+class InlineVector {
+public:
+    static constexpr size_t CAPACITY = N;
+
+    InlineVector() = default;
+    InlineVector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+    // Kapasite doluysa false döner ve eleman eklenmez.
+    bool push_back(const T &v) {
+        if (n == N) return false;
+        items[n++] = v;
+        return true;
+    }
+
+    template <typename It>
+    void assign(It first, It last) {
+        n = 0;
+        for (; first != last && n < N; ++first) items[n++] = *first;
+    }
+
+    void clear() { n = 0; }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    bool full() const { return n == N; }
+
+    T &operator[](size_t i) { return items[i]; }
+    const T &operator[](size_t i) const { return items[i]; }
+    T &back() { return items[n - 1]; }
+    const T &back() const { return items[n - 1]; }
+    T *data() { return items; }
+    const T *data() const { return items; }
+    T *begin() { return items; }
+    T *end() { return items + n; }
+    const T *begin() const { return items; }
+    const T *end() const { return items + n; }
+
+private:
+    T items[N] = {};
+    size_t n = 0;
+};
+
+// En fazla N-1 karakterlik, sıfırla biten ad. Uzun adlar kısaltılır; plan adı sınırı plan dosyası
+// yüklenirken ayrıca denetlenir.
+template <size_t N>
+class InlineString {
+public:
+    static constexpr size_t MAX_LENGTH = N - 1;
+
+    InlineString() = default;
+    InlineString(std::string_view s) { *this = s; }
+    InlineString(const char *s) { *this = std::string_view(s); }
+
+    InlineString &operator=(std::string_view s) {
+        len = std::min(s.size(), MAX_LENGTH);
+        std::memcpy(text, s.data(), len);
+        text[len] = '\0';
+        return *this;
+    }
+    InlineString &operator=(const char *s) { return *this = std::string_view(s); }
+
+    operator std::string_view() const { return {text, len}; }
+    std::string_view view() const { return {text, len}; }
+    const char *c_str() const { return text; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    // std::string::copy gibi: sonlandırıcı yazılmaz, kopyalanan karakter sayısı döner.
+    size_t copy(char *dest, size_t count) const {
+        size_t k = std::min(count, len);
+        std::memcpy(dest, text, k);
+        return k;
+    }
+
+    bool operator==(std::string_view s) const { return view() == s; }
+    bool operator!=(std::string_view s) const { return view() != s; }
+
+private:
+    char text[N] = {};
+    size_t len = 0;
+};
@@ -1,576 +1,380 @@
 #include <gpiod.h>      // libgpiod library
 #include <iostream>     // for screen messages
-#include <string>
-#include <unistd.h>     // for sleep()
-#include <algorithm>
-#include <thread>       // for synchronous functions
-#include <chrono>       // for milliseconds()
-#include <atomic>       // for atomic variables in threads (Aynı anda bir thread okurken başka biri güvenli şekilde yazabilir.)
-#include <random>       // for phase mode green times
-#include <ctime>        // for time()
-#include <iomanip>      // giriş/çıkış (I/O) biçimlendirme işlemleri
-#include <sstream>      // string tabanlı giriş/çıkış işlemleri
-#include <fstream>      // Dosyadan veri okumak-yazmak
-
-std::atomic<bool> inSeq(false);
-std::atomic<bool> inFlash(false);
-std::atomic<bool> inPhase(false);
-std::thread seqThread;
-std::thread flashThread;
-std::thread phaseThread;
-std::vector<int> phaseOrder = {0, 1, 2, 3};     // Phase modu için ilk faz sırası (t1-t2-t3-t4)
-std::vector<int> sequenceOrder = {0, 1, 2, 3};
-std::atomic<bool> runTimeoutWatcher(false);     // Zaman aşımı denetleyicisi
-std::thread timeoutWatcherThread;
-std::atomic<std::chrono::steady_clock::time_point> lastCommandTime;     // std::chrono::steady_clock::time_point tanımı şuanki zamanı tutar
-
-struct TrafficLight {
-    gpiod_line *red;        // TrafficLight t1 {r1, y1, g1};
-    gpiod_line *yellow;
-    gpiod_line *green;
-
-    int red_val = 0;
-    int yellow_val = 0;
-    int green_val = 0;
-
-    void set(int r, int y, int g) {
-        red_val = r;
-        yellow_val = y;
-        green_val = g;
-        gpiod_line_set_value(red, r);
-        gpiod_line_set_value(yellow, y);
-        gpiod_line_set_value(green, g);
-    }
-
-    std::string get_signal_group() {
-        if (red_val == 1 && yellow_val == 1) return "RED+YELLOW";
-        if (green_val == 1) return "GREEN";
-        if (yellow_val == 1) return "YELLOW";
-        if (red_val == 1) return "RED";
-        return "OFF";
-    }
-};
-
-void smart_sleep(int seconds, std::atomic<bool>&running) {
-    for (int i = 0; i < seconds * 10; ++i) {
-        if (!running) return;
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-}
-
-void phase_mode(std::vector<TrafficLight>&lights, std::atomic<bool>&running) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(3, 10);
-
-    while (running) {
-        for (int i = 0; i < phaseOrder.size(); ++i) {
-            int currled = phaseOrder[i];
-            int nextled = phaseOrder[(i + 1) % phaseOrder.size()];
-            for (int j = 0; j < lights.size(); ++j) {
-                lights[j].set(1, 0, 0);
-            }
-            lights[currled].set(0, 0, 1);
-            smart_sleep(dist(gen), running);
-            lights[currled].set(0, 1, 0);
-            smart_sleep(2, running);
-            lights[currled].set(1, 0, 0);
-            lights[nextled].set(1, 1, 0);
-            smart_sleep(2, running);
+#include <unistd.h>     // for read()
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "gpio_output.h"     // çip bazında toplu GPIO yazma
+#include "event_loop.h"      // epoll + timerfd olay döngüsü
+#include "mode_runner.h"     // mod durum makinelerini zamanlayıcıyla yürütür
+#include "pin_map.h"         // BeagleBone pin haritası
+#include "controller.h"      // komut tablosu ve işleyiciler
+#include "command_server.h"  // TCP/Unix soket komut sunucusu
+#include "signal_stream.h"   // SUBSCRIBE ile geçişlerin istemcilere akışı
+#include "serial_transport.h" // RS-232/RS-485 komut hattı
+#include "event_log.h"       // geçiş olay kaydı (mmap halka dosya)
+#include "detector_input.h"  // araç dedektörü girişleri (gpiod kenar olayları)
+#include "actuated_timing.h" // dedektörlere göre PHASE yeşil süreleri
+#include "state_checkpoint.h" // sıcak yeniden başlatma için durum kaydı
+#include "shm_state.h"       // yerel süreçler için /dev/shm durum segmenti
+#include "timing_thread.h"   // --rt: SCHED_FIFO zamanlama iş parçacığı
+#include "heap_guard.h"      // JUNCTION_HEAP_GUARD: başlangıçtan sonraki bellek ayırmalarını say
+
+int main(int argc, char **argv) {
+
+    bool use_mock = false;      // --mock: donanım olmadan sahte GPIO arka ucuyla çalış
+    int tcp_port = 0;           // --tcp PORT: ağ üzerinden komut sunucusu
+    const char *tcp_bind = "127.0.0.1";     // --tcp-bind ADDR: dinlenen adres (varsayılan yalnızca yerel)
+    const char *unix_path = nullptr;    // --unix PATH: yerel soket üzerinden komut sunucusu
+    const char *eventlog_path = nullptr;    // --eventlog PATH: geçiş olay kaydı dosyası
+    unsigned long eventlog_size = 1 << 20;  // --eventlog-size N: halkadaki kayıt sayısı (32 bayt/kayıt)
+    int stats_interval = 0;     // --stats-interval SEC: zamanlama istatistiklerini periyodik olarak yaz
+    bool actuated = false;      // --actuated: PHASE yeşil sürelerini araç dedektörlerinden belirle
+    const char *plan_file = nullptr;    // --plans FILE: SETMODE ile seçilebilen sinyal planları
+    const char *pin_file = nullptr;     // --pins FILE: kafa, LED ve dedektör hatları
+    const char *state_path = nullptr;   // --state PATH: sıcak yeniden başlatma kaydı
+    const char *shm_name = nullptr;     // --shm NAME: durumu /dev/shm segmentine yayınla
+    const char *trace_path = nullptr;   // --trace FILE: komutları ve yanıtları iz dosyasına kaydet
+    const char *serial_path = nullptr;  // --serial DEV: seri hattan komut al
+    long baud = 115200;                 // --baud N
+    bool rs485 = false;                 // --rs485: RTS ile yön denetimi
+    bool realtime = false;              // --rt: zamanlama yolu ayrı, SCHED_FIFO öncelikli iş parçacığında
+    RtConfig rtConfig;
+    rtConfig.cpu = rt_last_cpu();       // --rt-cpu N: zamanlama iş parçacığının çekirdeği (varsayılan sonuncusu)
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--mock") == 0) use_mock = true;
+        else if (std::strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) tcp_port = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--tcp-bind") == 0 && i + 1 < argc) tcp_bind = argv[++i];
+        else if (std::strcmp(argv[i], "--unix") == 0 && i + 1 < argc) unix_path = argv[++i];
+        else if (std::strcmp(argv[i], "--eventlog") == 0 && i + 1 < argc) eventlog_path = argv[++i];
+        else if (std::strcmp(argv[i], "--eventlog-size") == 0 && i + 1 < argc) eventlog_size = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--stats-interval") == 0 && i + 1 < argc) stats_interval = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--actuated") == 0) actuated = true;
+        else if (std::strcmp(argv[i], "--plans") == 0 && i + 1 < argc) plan_file = argv[++i];
+        else if (std::strcmp(argv[i], "--pins") == 0 && i + 1 < argc) pin_file = argv[++i];
+        else if (std::strcmp(argv[i], "--state") == 0 && i + 1 < argc) state_path = argv[++i];
+        else if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) shm_name = argv[++i];
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+        else if (std::strcmp(argv[i], "--serial") == 0 && i + 1 < argc) serial_path = argv[++i];
+        else if (std::strcmp(argv[i], "--baud") == 0 && i + 1 < argc) baud = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--rs485") == 0) rs485 = true;
+        else if (std::strcmp(argv[i], "--rt") == 0) realtime = true;
+        else if (std::strcmp(argv[i], "--rt-cpu") == 0 && i + 1 < argc) rtConfig.cpu = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rt-priority") == 0 && i + 1 < argc) rtConfig.priority = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Kullanım: " << argv[0] << " [--mock] [--tcp PORT] [--tcp-bind ADDR] [--unix PATH] [--eventlog PATH] [--eventlog-size N]"
+                      << " [--stats-interval SEC] [--actuated] [--plans FILE] [--pins FILE] [--state PATH] [--shm NAME]"
+                      << " [--serial DEV] [--baud N] [--rs485] [--trace FILE] [--rt] [--rt-cpu N] [--rt-priority N]\n";
+            return 1;
         }
     }
-}
 
-void flash_mode(std::vector<TrafficLight>&lights, std::atomic<bool>&running) {
-    while (running) {
-        for (int i = 0; i < lights.size(); ++i) {
-            lights[i].set(0, 1, 0);
+    // Bellek ilk ayırmalardan önce kilitlenir; zamanlama yolunda sayfa hatası olmaz.
+    if (realtime) {
+        std::string error;
+        if (!rt_lock_memory(error)) {
+            std::cerr << "Bellek kilitlenemedi: " << error << "\n";
+            return 1;
         }
-        smart_sleep(1, running);
-        for (int i = 0; i < lights.size(); ++i) {
-            lights[i].set(0, 0, 0);
-        }
-        smart_sleep(1, running);
     }
-}
 
-void sequence_mode(std::vector<TrafficLight>&lights, std::atomic<bool>&running) {
-    while (running) {
-        for (int i = 0; i < sequenceOrder.size(); ++i) {
-            if (!running) return;
-            int currled = sequenceOrder[i];
-            int nextled = sequenceOrder[(i + 1) % sequenceOrder.size()];
-            for (int j = 0; j < lights.size(); ++j) {
-                if (j == currled)
-                    lights[j].set(0, 0, 1); // Sıradaki ışık yeşil
-                else
-                    lights[j].set(1, 0, 0); // Diğerleri kırmızı
-            }
-            smart_sleep(5, running);
-            if (!running) return;
-            lights[currled].set(0, 1, 0);
-            smart_sleep(2, running);
-            if (!running) return;
-            lights[currled].set(1, 0, 0);
-            lights[nextled].set(1, 1, 0);
-            smart_sleep(2, running);
-            if (!running) return;
+    PinConfig pinConfig = default_pin_config();
+    if (pin_file) {
+        std::string error;
+        if (!load_pin_file(pin_file, pinConfig, error)) {
+            std::cerr << "Pin dosyası hatalı: " << error << "\n";
+            return 1;
         }
     }
-}
-
-void reset_lights(std::vector<TrafficLight>&lights) {
-    for (int i = 0; i < lights.size(); ++i) {
-        lights[i].set(0, 0, 0);
+    const int heads = pinConfig.heads;
+
+    // Kayıt aynı açılışta yazılmış, düzgün kapanmamış ve aynı pin haritasına aitse ışıklar
+    // söndürülmeden kaldığı yerden devam edilir.
+    StateCheckpoint checkpoint;
+    bool warm = false;
+    if (state_path) {
+        if (!checkpoint.open(state_path)) {
+            std::cerr << "Durum kaydı dosyası açılamadı: " << state_path << "\n";
+            return 1;
+        }
+        const CheckpointState &s = checkpoint.last();
+        warm = checkpoint.resumable() && s.head_count == heads && s.pin_count == (int)pinConfig.pins.size();
     }
-}
 
-void timeout_watcher(std::vector<TrafficLight>&lights, std::atomic<bool>&running, std::string &minseqtimeout_ref, std::string &activemode_ref) {
-    while (running) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        if (inPhase) {
-            auto now = std::chrono::steady_clock::now();
-            auto last_cmd_time = lastCommandTime.load();
-            auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(now - last_cmd_time).count();
-            int timeout_duration = std::stoi(minseqtimeout_ref);        // string to int
-            if (elapsed_seconds >= timeout_duration) {
-                std::cout << "Zaman aşımı! " << timeout_duration << " saniyedir komut gelmedi. PHASE modundan SEQUENCE moduna geçiliyor...\n";
-                std::cout << "Komut giriniz: " << std::flush;       // yazılan veriyi hemen ekrana basar
-                inPhase = false;
-                if (phaseThread.joinable()) {
-                    phaseThread.join();
-                }
-                activemode_ref = "SEQUENCE";
-                reset_lights(lights);
-                inSeq = true;
-                seqThread = std::thread(sequence_mode, std::ref(lights), std::ref(inSeq));
-                lastCommandTime = std::chrono::steady_clock::now();     // Kronometreyi sıfırla
-            }
+    GpiodBackend gpiod_backend;
+    MockBackend mock_backend;
+    OutputBackend &backend = use_mock ? static_cast<OutputBackend &>(mock_backend) : gpiod_backend;
+    EventLog eventLog(heads);               // çıkıştan önce kurulur, ondan sonra yok edilir
+    JunctionOutput out(backend, pinConfig.pins);
+    if (eventlog_path) {
+        if (!eventLog.open(eventlog_path, eventlog_size)) {
+            std::cerr << "Olay kaydı dosyası açılamadı: " << eventlog_path << "\n";
+            return 1;
         }
+        if (!realtime) out.add_observer(&eventLog);     // --rt ile EventLogRelay üzerinden
     }
-}
-
-void start_mode(const std::string &activemode, std::vector<TrafficLight> &lights) {
-    if (activemode == "SEQUENCE") {
-        inSeq = true;
-        seqThread = std::thread(sequence_mode, std::ref(lights), std::ref(inSeq));
-        std::cout << "Sistem SEQUENCE modunda başlatıldı.\n";
-    } else if (activemode == "FLASH") {
-        inFlash = true;
-        flashThread = std::thread(flash_mode, std::ref(lights), std::ref(inFlash));
-        std::cout << "Sistem FLASH modunda başlatıldı.\n";
-    } else if (activemode == "PHASE") {
-        inPhase = true;
-        phaseThread = std::thread(phase_mode, std::ref(lights), std::ref(inPhase));
-        std::cout << "Sistem PHASE modunda başlatıldı.\n";
+    if (!out.init(warm ? checkpoint.last().outputs : 0)) {      // hatlar çip başına tek istekle, son değerleriyle alınır
+        std::cerr << "GPIO hatları alınamadı!\n";
+        return 1;
     }
-}
-
-std::string format_tm(const std::tm& t) {       //time değeri için sadece okunuyor ve bu içerikten yeni bir string üretiliyor.
-    char time_buf[64];
-    std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", &t);
-    return std::string(time_buf);
-}
 
-std::string format_order_vector(const std::vector<int>& order) {        // GETORDER komutu için ışık sıralarından string oluşturur.
-    std::stringstream ss;
-    for (size_t i = 0; i < order.size(); ++i) {
-        ss << "t" << (order[i] + 1);
-        if (i < order.size() - 1) {
-            ss << "-";
-        }
+    // Zamanlayıcılar ve dedektör girişleri --rt ile zamanlama iş parçacığının döngüsündedir; soketler,
+    // seri hat, standart giriş ve iz dosyası her zaman ana döngüdedir.
+    EventLoop loop;
+    TimingThread timingThread;
+    EventLoop &timingLoop = realtime ? timingThread.loop : loop;
+    SteadyClock clock;
+    Timer modeTimer(timingLoop);
+    Timer timeoutTimer(timingLoop);
+    ModeRunner runner(out, clock, modeTimer, heads);
+    // Olay kaydı ve durum kaydı diskteki dosyalardır; --rt ile ana döngüde yazılır.
+    std::unique_ptr<EventLogRelay> eventLogRelay;
+    std::unique_ptr<CheckpointRelay> checkpointRelay;
+    if (realtime && eventlog_path) {
+        eventLogRelay = std::make_unique<EventLogRelay>(loop, eventLog);
+        out.add_observer(eventLogRelay.get());
     }
-    return ss.str();
-}
-
-int main() {
-
-    int r1_pin = 13;           // P8_11 tanımlama
-    int y1_pin = 12;           // P8_12 tanımlama
-    int g1_pin = 26;           // P8_14 tanımlama
-
-    int r2_pin = 15;           // P8_15 tanımlama
-    int y2_pin = 14;           // P8_16 tanımlama
-    int g2_pin = 27;           // P8_17 tanımlama
-  
-    int r3_pin = 1;            // P8_18 tanımlama
-    int y3_pin = 29;           // P8_26 tanımlama
-    int g3_pin = 28;           // P9_12 tanımlama
- 
-    int r4_pin = 16;           // P9_15 tanımlama
-    int y4_pin = 17;           // P9_23 tanımlama
-    int g4_pin = 19;           // P9_27 tanımlama
-
-    int status_led_pin = 18; // P9_14 durum LED'i pini
-
-    gpiod_chip *chip0 = gpiod_chip_open_by_name("gpiochip0");
-    gpiod_chip *chip1 = gpiod_chip_open_by_name("gpiochip1");
-    gpiod_chip *chip2 = gpiod_chip_open_by_name("gpiochip2");
-    gpiod_chip *chip3 = gpiod_chip_open_by_name("gpiochip3");
-
-    gpiod_line *r1 = gpiod_chip_get_line(chip1, r1_pin);
-    gpiod_line_request_output(r1, "led_control", 0);    
-    gpiod_line *y1 = gpiod_chip_get_line(chip1, y1_pin);
-    gpiod_line_request_output(y1, "led_control", 0);
-    gpiod_line *g1 = gpiod_chip_get_line(chip0, g1_pin);
-    gpiod_line_request_output(g1, "led_control", 0);
-
-    gpiod_line *r2 = gpiod_chip_get_line(chip1, r2_pin);
-    gpiod_line_request_output(r2, "led_control", 0);    
-    gpiod_line *y2 = gpiod_chip_get_line(chip1, y2_pin);
-    gpiod_line_request_output(y2, "led_control", 0);
-    gpiod_line *g2 = gpiod_chip_get_line(chip0, g2_pin);
-    gpiod_line_request_output(g2, "led_control", 0);
-
-    gpiod_line *r3 = gpiod_chip_get_line(chip2, r3_pin);
-    gpiod_line_request_output(r3, "led_control", 0);    
-    gpiod_line *y3 = gpiod_chip_get_line(chip1, y3_pin);
-    gpiod_line_request_output(y3, "led_control", 0);
-    gpiod_line *g3 = gpiod_chip_get_line(chip1, g3_pin);
-    gpiod_line_request_output(g3, "led_control", 0);
-
-    gpiod_line *r4 = gpiod_chip_get_line(chip1, r4_pin);
-    gpiod_line_request_output(r4, "led_control", 0);    
-    gpiod_line *y4 = gpiod_chip_get_line(chip1, y4_pin);
-    gpiod_line_request_output(y4, "led_control", 0);
-    gpiod_line *g4 = gpiod_chip_get_line(chip3, g4_pin);
-    gpiod_line_request_output(g4, "led_control", 0);
-
-    gpiod_line *status_led = gpiod_chip_get_line(chip1, status_led_pin);
-    gpiod_line_request_output(status_led, "status_led", 0);
-
-    std::string timezone = "UTC+3";
-    bool customTimeSet = false;                      // Kullanıcı SETTIME komutu verdi mi?
-    std::tm custom_tm = {};                          // Kullanıcının girdiği zaman (tm yapısında)
-    std::chrono::steady_clock::time_point setPoint;  // SETTIME anındaki steady_clock zamanı
-    std::string minseqtimeout = "40";
-    std::string activemode = "SEQUENCE";
-    const std::string initial_mode = activemode;        // RESET komutu için başlangıç modunu saklarız.
-
-    TrafficLight t1 {r1, y1, g1};       // t1.red = r1, t1.yellow = y1, t1.green = g1
-    TrafficLight t2 {r2, y2, g2};
-    TrafficLight t3 {r3, y3, g3};
-    TrafficLight t4 {r4, y4, g4};
-    std::vector<TrafficLight> lights = {t1, t2, t3, t4};
-
-    lastCommandTime = std::chrono::steady_clock::now();         // kronometreyi başlat
-    runTimeoutWatcher = true;
-    timeoutWatcherThread = std::thread(timeout_watcher, std::ref(lights), std::ref(runTimeoutWatcher), std::ref(minseqtimeout), std::ref(activemode));
-    std::cout << "Program başlatılıyor...\n";
-    std::cout << "Komut bilgi ekranı için INFO komutunu veriniz.\n";
-    start_mode(activemode, lights);
-    gpiod_line_set_value(status_led, 1);
-
-    while (true) {
-
-        std::string komut;
-        std::cout << "Komut giriniz: ";
-        std::getline(std::cin, komut);
-        lastCommandTime = std::chrono::steady_clock::now();
-
-
-        size_t pos;                                                     // unsigned integer
-        while ((pos = komut.find("\\r")) != std::string::npos) {        // "\\r" bulunuyorsa
-            komut.replace(pos, 2, "\r");
-        }
-
-        komut.erase(std::remove(komut.begin(), komut.end(), '\r'), komut.end());
-
-        if (komut == "GETVERSION") {
-            std::cout << "VERSION=2.5\n";
-        }
-
-        else if (komut == "GETTIME") {
-            if (customTimeSet) {        // SETTIME ile kullanıcı zaman girdiyse
-            auto now = std::chrono::steady_clock::now();        // güncel zaman
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - setPoint).count();      // SET komutu sonrası geçen zaman bulunur
-            std::tm current_tm = custom_tm;
-            time_t custom_time_t = std::mktime(&current_tm);
-            custom_time_t += elapsed;                         // Kullanıcı saatine geçen süreyi ekle
-            std::tm updated_tm;
-            localtime_r(&custom_time_t, &updated_tm);
-            std::cout << "TIME=" << format_tm(updated_tm) << "\n";
-            } else {
-                time_t now = std::time(nullptr);        // direkt sistem saati alınır
-                std::tm system_tm;
-                localtime_r(&now, &system_tm);
-                std::cout << "TIME=" << format_tm(system_tm) << "\n";
-              }
-        }
-
-        else if (komut.rfind("SETTIME=", 0) == 0) {
-            std::string ftime = komut.substr(8);
-            std::tm t = {};
-            strptime(ftime.c_str(), "%Y-%m-%d %H:%M:%S", &t);
-            custom_tm = t;
-            customTimeSet = true;       // kullanıcının SETTIME ile yeni zaman değeri girdiğini gösterir
-            setPoint = std::chrono::steady_clock::now();
-            std::cout << "Zaman güncellendi: " << ftime << "\n";
+    if (realtime && state_path) checkpointRelay = std::make_unique<CheckpointRelay>(loop, checkpoint);
+
+    // Bütün gruplar varsayılan olarak çakışır; plan dosyası uyumlu grupları ve ara süreleri belirtebilir.
+    ConflictRules conflictRules(heads, 3000);
+    TimeSchedule schedule;      // plan dosyasındaki "schedule" satırları
+    if (plan_file) {        // planlar başlangıçta doğrulanır; hatalı dosyayla çalışılmaz
+        std::string error;
+        if (!load_plan_file(plan_file, runner.plans, error, &conflictRules, &schedule)) {
+            std::cerr << "Plan dosyası hatalı: " << error << "\n";
+            return 1;
         }
-
-        else if (komut == "GETTIMEZONE") {
-            std::ifstream tzfile("/etc/timezone");
-            std::string tz;
-            std::getline(tzfile, tz);
-            std::cout << "TIMEZONE=" << tz << "\n";
-        }
-
-        else if (komut.rfind("SETTIMEZONE=", 0) == 0) {
-            std::string new_tz = komut.substr(12);
-            std::ofstream tzfile("/etc/timezone");
-            tzfile << new_tz << "\n";
-            tzfile.close();
-            setenv("TZ", new_tz.c_str(), 1);
-            tzset();
-            std::cout << "Zaman dilimi güncellendi: " << new_tz << "\n";
-        }
-        
-        else if (komut == "CPUVER") {
-            std::cout << "CPUVER=AM3358BZC\n";
-        }
-
-        else if (komut == "GETSIGNALGROUP") {
-            std::string sonuc = "";
-            for (int i = 0; i < lights.size(); ++i) {
-                sonuc += "t" + std::to_string(i + 1) + ":" + lights[i].get_signal_group();
-                if (i != lights.size() - 1) {
-                    sonuc += ", ";
-                }
+        for (const SignalPlan &p : runner.plans) {
+            if (p.groups != heads) {
+                std::cerr << "Plan " << p.name.c_str() << " " << p.groups << " grup içeriyor, kavşakta " << heads << " kafa var\n";
+                return 1;
             }
-            std::cout << sonuc << "\n";
         }
-
-        else if (komut.rfind("SETPHASEORDER=", 0) == 0) {
-            std::string siraliKomut = komut.substr(14);     // "t1-t2-t3-t4" kısmını al
-            std::stringstream ss(siraliKomut);
-            std::string parca;
-            std::vector<int> yeniSira;
-            bool kullanilanYonler[4] = {false};
-            while (std::getline(ss, parca, '-')) {
-                if (parca.length() == 2 && parca[0] == 't') {       // Her bir parçayı ("t1", "t2" vb.) kontrol et
-                    char yonNo = parca[1];
-                    if (yonNo >= '1' && yonNo <= '4') {
-                        int index = yonNo - '1';
-                        if (!kullanilanYonler[index]) {
-                            yeniSira.push_back(index);
-                            kullanilanYonler[index] = true;
-                        } else {        // Hata: Aynı yön birden fazla kullanılmış
-                            yeniSira.clear();       // Hatalı durumu belirtmek için listeyi temizle
-                            break;
-                        }
-                    } else {        // Hata: 't5' gibi geçersiz bir yön
-                        yeniSira.clear();
-                        break;
-                    }
-                } else {        // Hata: "t1" formatına uymayan bir parça
-                    yeniSira.clear();
-                    break;
-                }
-            }
-            if (yeniSira.size() == 4) {
-                phaseOrder = yeniSira;
-                std::cout << "Phase sırası güncellendi: " << siraliKomut << "\n";
-                if (inPhase) {
-                    inPhase = false;
-                    if (phaseThread.joinable()) {
-                        phaseThread.join();
-                    }
-                    reset_lights(lights);
-                    inPhase = true;
-                    phaseThread = std::thread(phase_mode, std::ref(lights), std::ref(inPhase));
-                    std::cout << "PHASE modu yeni sırayla yeniden başlatıldı.\n";
-                } else {
-                    std::cout << "Uyarı: Sistem PHASE modunda değil. Sıra kaydedildi ama şu anda uygulanamadı.\n";
-                }
-            } else {
-                std::cout << "Hatalı komut! Doğru format: SETPHASEORDER=t1-t2-t3-t4 (4 farklı ve geçerli yön kullanın)\n";
-            }
+    }
+    for (const SignalPlan *p : {&runner.sequencePlan, &runner.phasePlan, &runner.flashPlan}) {
+        std::string error;
+        if (!check_plan_conflicts(*p, conflictRules, error)) {
+            std::cerr << "Plan çakışma kurallarına uymuyor: " << error << "\n";
+            return 1;
         }
-
-        else if (komut.rfind("SETSEQORDER=", 0) == 0) {
-            std::string siraliKomut = komut.substr(12);
-            std::stringstream ss(siraliKomut);
-            std::string parca;
-            std::vector<int> yeniSira;
-            bool kullanilanYonler[4] = {false};
-            while (std::getline(ss, parca, '-')) {
-                if (parca.length() == 2 && parca[0] == 't') {
-                    char yonNo = parca[1];
-                    if (yonNo >= '1' && yonNo <= '4') {
-                        int index = yonNo - '1';
-                        if (!kullanilanYonler[index]) {
-                            yeniSira.push_back(index);
-                            kullanilanYonler[index] = true;
-                        } else {
-                            yeniSira.clear();
-                            break;
-                        }
-                    } else {
-                        yeniSira.clear();
-                        break;
-                    }
-                } else {
-                    yeniSira.clear();
-                    break;
-                }
-            }
-            if (yeniSira.size() == 4) {
-                sequenceOrder = yeniSira;
-                std::cout << "Sequence sırası güncellendi: " << siraliKomut << "\n";
-                if (inSeq) {
-                    inSeq = false;
-                    if (seqThread.joinable()) {
-                        seqThread.join();
-                    }
-                    reset_lights(lights);
-                    inSeq = true;
-                    seqThread = std::thread(sequence_mode, std::ref(lights), std::ref(inSeq));
-                    std::cout << "SEQUENCE modu yeni sırayla yeniden başlatıldı.\n";
-                } else {
-                    std::cout << "Uyarı: Sistem SEQUENCE modunda değil. Sıra kaydedildi ama şu anda uygulanamadı.\n";
+    }
+    ConflictMonitor conflictMonitor(conflictRules, &clock);
+    out.monitor = &conflictMonitor;
+
+    // Dedektör olayları aynı döngüden okunur; yalnızca sayaçları günceller, ışıklara dokunmaz.
+    DetectorBank detectors(heads);
+    ActuatedTiming timing{detectors};
+    GpiodDetectorInput detectorInput(timingLoop, detectors);
+    if (actuated) {
+        if (!use_mock) {        // sahte arka uçta dedektör yoktur; yeşiller en kısa sürede kalır
+            for (const DetectorPin &pin : pinConfig.detectors) {
+                if (!detectorInput.add(pin)) {
+                    std::cerr << "Dedektör hattı alınamadı: gpiochip" << pin.chip << " " << pin.offset << "\n";
+                    return 1;
                 }
-            } else {
-                std::cout << "Hatalı komut! Format: t1-t2-t3-t4 (4 farklı ve geçerli yön kullanın)\n";
             }
         }
-
-        else if (komut == "GETORDER") {
-            std::string phase_str = format_order_vector(phaseOrder);
-            std::string seq_str = format_order_vector(sequenceOrder);
-            std::cout << "Phase mode sirasi: " << phase_str << "\n";
-            std::cout << "Sequence mode sirasi: " << seq_str << "\n";
+        runner.actuation = &timing;
+    }
+    Controller controller(out, runner, clock, timeoutTimer);
+    Timer scheduleTimer(timingLoop);
+    ModeScheduler scheduler(schedule, controller.civil, clock, scheduleTimer);
+    if (!schedule.empty()) {
+        std::string error;
+        if (!controller.attach_schedule(schedule, scheduler, error)) {
+            std::cerr << "Zaman çizelgesi hatalı: " << error << "\n";
+            return 1;
         }
-
-        else if (komut == "GETMINSEQTIMEOUT") {
-            std::cout << "MINSEQTIMEOUT=" << minseqtimeout << " saniye\n";
+    }
+    SerialTransport serial(loop, controller);
+    if (serial_path) {
+        std::string error;
+        if (!serial.open(serial_path, baud, rs485, error)) {
+            std::cerr << "Seri port açılamadı: " << error << "\n";
+            return 1;
         }
+        serial.on_close = [] { std::cerr << "Seri port kapandı.\n"; };
+    }
+    SignalStream signalStream(runner, controller.civil);     // sunucudan önce kurulur, abone kuyrukları ondan sonra yok edilir
+    std::unique_ptr<StreamRelay> streamRelay;
+    if (realtime) {         // geçişler kuyrukla ana döngüye taşınır, orada kodlanıp gönderilir
+        streamRelay = std::make_unique<StreamRelay>(runner, controller.civil, loop, signalStream);
+        out.add_observer(streamRelay.get());
+    } else {
+        out.add_observer(&signalStream);
+    }
+    signalStream.pool.reserve(4 * SubscriberQueue::CAPACITY);  // dört yavaş aboneye kadar
+    CommandServer server(loop, controller, &signalStream);
+    if (tcp_port && !server.listen_tcp(tcp_port, tcp_bind)) {
+        std::cerr << "TCP portu açılamadı: " << tcp_bind << ":" << tcp_port << "\n";
+        return 1;
+    }
+    if (unix_path && !server.listen_unix(unix_path)) {
+        std::cerr << "Unix soketi açılamadı: " << unix_path << "\n";
+        return 1;
+    }
 
-        else if (komut.rfind("SETMINSEQTIMEOUT=", 0) == 0) {
-            minseqtimeout = komut.substr(17);
-            std::cout << "Minumum zaman aşımı süresi güncellendi: " << minseqtimeout << " saniye\n";
+    ShmStateWriter shmState;
+    if (shm_name) {
+        if (!shmState.open(shm_name)) {
+            std::cerr << "Paylaşımlı bellek segmenti açılamadı: " << shm_name << "\n";
+            return 1;
         }
+        controller.shm = &shmState;
+    }
 
-        else if (komut == "GETMODE") {
-            std::cout << "ACTIVEMOD=" << activemode << "\n";
+    ProtocolTraceWriter trace;
+    if (trace_path) {
+        if (!trace.open(trace_path)) {
+            std::cerr << "İz dosyası açılamadı: " << trace_path << "\n";
+            return 1;
         }
+        controller.trace = &trace;
+    }
 
-        else if (komut.rfind("SETMODE=", 0) == 0) {
-            activemode = komut.substr(8);
-            std::cout << "Çalışma modu güncellendi: " << activemode << "\n";
-
-            if (inSeq) {        // önceki durumlar temizlenir
-                inSeq = false;
-                if (seqThread.joinable()) seqThread.join();
-                std::cout << "SEQUENCE durduruldu.\n";
-            }
-
-            if (inFlash) {
-                inFlash = false;
-                if (flashThread.joinable()) flashThread.join();
-                std::cout << "FLASH durduruldu.\n";
-            }
-
-            if (inPhase) {
-                inPhase = false;
-                if (phaseThread.joinable()) phaseThread.join();
-                std::cout << "PHASE durduruldu.\n";
-            }
-            reset_lights(lights);
-
-            if (activemode == "SEQUENCE") {
-                inSeq = true;
-                seqThread = std::thread(sequence_mode, std::ref(lights), std::ref(inSeq));
-                std::cout << "SEQUENCE mode başlatıldı.\n";
-            }
-
-            else if (activemode == "FLASH") {
-                inFlash = true;
-                flashThread = std::thread(flash_mode, std::ref(lights), std::ref(inFlash));
-                std::cout << "FLASH mode başlatıldı.\n";
-            }
-
-            else if (activemode == "PHASE") {
-                inPhase = true;
-                phaseThread = std::thread(phase_mode, std::ref(lights), std::ref(inPhase));
-                std::cout << "PHASE mode başlatıldı.\n";
-            }
-        }     
+    std::cout << "Program başlatılıyor...\n";
+    std::cout << "Komut bilgi ekranı için INFO komutunu veriniz.\n";
+    if (state_path) controller.checkpoint = &checkpoint;
+    if (warm) controller.resume(checkpoint.last());
+    else controller.start();
+
+    const bool serving = tcp_port || unix_path || serial_path;
+
+    // İstatistik dökümü standart hataya yazılır; komut istemiyle karışmaz, ayrı bir dosyaya yönlendirilebilir.
+    Timer statsTimer(loop);
+    Clock::time_point statsDeadline = clock.now();
+    ReplyBuffer statsReply;
+    if (stats_interval > 0) {
+        statsTimer.on_expire([&] {
+            statsReply.clear();
+            controller.on_timing_thread([&] { cmd_getstats(controller, {}, statsReply); });
+            std::cerr << statsReply.view() << std::flush;
+            statsDeadline += std::chrono::seconds(stats_interval);
+            statsTimer.arm_at(statsDeadline);
+        });
+        statsDeadline += std::chrono::seconds(stats_interval);
+        statsTimer.arm_at(statsDeadline);
+    }
 
-        else if (komut == "GETERROR") {
-            std::cout << "ERROR=1\n";
-        }
+    // Geçiş olmasa da (uzun yeşil, CLOSE) okuyucular kontrolcünün yaşadığını heartbeat'ten görür.
+    Timer shmTimer(loop);
+    Clock::time_point shmDeadline = clock.now();
+    if (shm_name) {
+        shmTimer.on_expire([&] {
+            controller.on_timing_thread([&] { controller.publish_state(); });
+            shmDeadline += std::chrono::seconds(1);
+            shmTimer.arm_at(shmDeadline);
+        });
+        shmDeadline += std::chrono::seconds(1);
+        shmTimer.arm_at(shmDeadline);
+    }
 
-        else if (komut == "INFO") {
-            std::cout << "\n--- Komut Bilgi Ekranı ---\n";
-            std::cout << "GETVERSION\t\t: Versiyon bilgisi verilir.\n";
-            std::cout << "CPUVER\t\t\t: İşlemci bilgisi verilir.\n";
-            std::cout << "GETTIME\t\t\t: Anlık zaman bilgisi verilir.\n";
-            std::cout << "SETTIME=\t\t: y-m-d H:M:S formatında zaman bilgisi değiştirilir. (Örnek: SETTIME=2001-09-17 14:30:15)\n";
-            std::cout << "GETTIMEZONE\t\t: Anlık zaman bölge bilgisi verilir.\n";
-            std::cout << "SETTIMEZONE=\t\t: UTC formatında zaman bölge bilgisi değiştirilir. (Örnek: SETTIMEZONE=UTC+1)\n";
-            std::cout << "GETSIGNALGROUP\t\t: Işıkların anlık durum bilgisi verilir.\n";
-            std::cout << "GETORDER\t\t: Phase ve Sequence modlarındaki ışıkların yanma sıralarını gösterir.\n";
-            std::cout << "SETPHASEORDER=\t\t: PHASE modunda ışıkların yanma sırasını değiştirir. (Örnek: SETPHASEORDER=t4-t3-t2-t1)\n";
-            std::cout << "SETSEQORDER=\t\t: SEQUENCE modunda ışıkların yanma sırasını değiştirir. (Örnek: SETSEQORDER=t4-t3-t2-t1)\n";
-            std::cout << "GETMINSEQTIMEOUT\t: Zaman aşımı süre bilgisi verilir.\n";
-            std::cout << "SETMINSEQTIMEOUT=\t: Zaman aşımı süresi değiştirilir.\n";
-            std::cout << "GETMODE\t\t\t: Aktif mod bilgisi verilir.\n";
-            std::cout << "SETMODE=\t\t: Aktif mod SEQUENCE, FLASH ve PHASE arasında değiştirilir. (Örnek: SETMODE=FLASH)\n";
-            std::cout << "GETERROR\t\t: Hata bilgisi verilir.\n";
-            std::cout << "RESET\t\t\t: Sistem başlangıç modunda ve geçerli değişkenlerde yeniden başlatılır.\n";
-            std::cout << "CLOSE\t\t\t: Işıklar kapatılır.\n";
-            std::cout << "INFO\t\t\t: Komut bilgi ekranı açılır.\n";
-            std::cout << "---------------------------\n";
-        }
+    // İz tamponu saniyede bir dosyaya eklenir; çökmede en fazla son saniyenin komutları kaybolur.
+    Timer traceTimer(loop);
+    Clock::time_point traceDeadline = clock.now();
+    if (trace_path) {
+        traceTimer.on_expire([&] {
+            trace.flush();
+            traceDeadline += std::chrono::seconds(1);
+            traceTimer.arm_at(traceDeadline);
+        });
+        traceDeadline += std::chrono::seconds(1);
+        traceTimer.arm_at(traceDeadline);
+    }
 
-        else if (komut == "RESET") {
-            std::cout << "Sistem sıfırlanıyor ve başlangıç moduna dönülüyor...\n";
-            inPhase = false;
-            inSeq = false;
-            inFlash = false;
-            if (phaseThread.joinable()) phaseThread.join();
-            if (seqThread.joinable()) seqThread.join();
-            if (flashThread.joinable()) flashThread.join();
-            reset_lights(lights);
-            activemode = initial_mode;
-            std::cout << "Aktif mod, başlangıç modu olan '" << activemode << "' olarak ayarlandı.\n";
-            if (activemode == "PHASE") {
-                inPhase = true;
-                phaseThread = std::thread(phase_mode, std::ref(lights), std::ref(inPhase));
-                std::cout << "Sistem PHASE modunda yeniden başlatıldı.\n";
-            } else if (activemode == "SEQUENCE") {
-                inSeq = true;
-                seqThread = std::thread(sequence_mode, std::ref(lights), std::ref(inSeq));
-                std::cout << "Sistem SEQUENCE modunda yeniden başlatıldı.\n";
-            } else if (activemode == "FLASH") {
-                inFlash = true;
-                flashThread = std::thread(flash_mode, std::ref(lights), std::ref(inFlash));
-                std::cout << "Sistem FLASH modunda yeniden başlatıldı.\n";
-            } else {
-                std::cout << "Bilinmeyen başlangıç modu: " << activemode << "\n";
-            }
+    // SIGINT/SIGTERM döngüden işlenir; ışıklar söndürülür ve soket dosyası silinir. SIGUSR1 devir
+    // içindir (sürüm yükseltme): ışıklara dokunulmadan çıkılır, yeni süreç kayıttan devam eder.
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    sigaddset(&stop_signals, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &stop_signals, nullptr);
+    int sigfd = signalfd(-1, &stop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    bool handover = false;
+    loop.watch(sigfd, EPOLLIN, [&](uint32_t) {
+        signalfd_siginfo info;
+        if (read(sigfd, &info, sizeof(info)) == sizeof(info)) handover = info.ssi_signo == SIGUSR1 && state_path;
+        loop.stop();
+    });
+
+    // Komutlar satır satır gelir; okunabilen her şey okunur, tamamlanan satırlar işlenir.
+    char input[1024];
+    size_t input_len = 0;
+    ReplyBuffer reply;
+    bool stdin_ok = loop.watch(STDIN_FILENO, EPOLLIN, [&](uint32_t) {
+        ssize_t n = read(STDIN_FILENO, input + input_len, sizeof(input) - input_len);
+        if (n <= 0) {       // giriş kapandı; sunucu açıksa yalnızca soketlerle devam edilir
+            if (serving) loop.unwatch(STDIN_FILENO);
+            else loop.stop();
+            return;
         }
-
-        else if (komut == "CLOSE") {
-        std::cout << "Tüm ışıklar kapatılıyor...\n";        
-        std::cout << "RESET komutu ile sistemi yeniden başlatabilirsiniz.\n";
-
-            if (inSeq || inFlash || inPhase) {
-                inSeq = false;
-                inFlash = false;
-                inPhase = false;
-                if (seqThread.joinable()) seqThread.join();
-                if (flashThread.joinable()) flashThread.join();
-                if (phaseThread.joinable()) phaseThread.join();
-            }
-            reset_lights(lights);
+        input_len += n;
+        size_t start = 0;
+        for (size_t i = 0; i < input_len; ++i) {
+            if (input[i] != '\n') continue;
+            reply.clear();
+            controller.handle_line(std::string_view(input + start, i - start), reply);
+            std::cout << reply.view() << "Komut giriniz: " << std::flush;
+            start = i + 1;
         }
-
-        else {
-            std::cout << "Bilinmeyen komut!\n";
+        if (start == 0 && input_len == sizeof(input)) start = input_len;      // satır çok uzun, atılır
+        std::memmove(input, input + start, input_len - start);
+        input_len -= start;
+    });
+    if (!stdin_ok && !serving) {
+        std::cerr << "Standart giriş izlenemiyor!\n";
+        return 1;
+    }
+    // Başlangıç tek iş parçacığında yapıldı; bundan sonra kontrolcü durumu zamanlama iş parçacığınındır.
+    NoticeRelay notices(loop, [](std::string_view text) { std::cout << text << std::flush; });
+    if (realtime) {
+        controller.on_notice = [&notices](std::string_view text) { notices.post(text); };
+        if (checkpointRelay) controller.on_checkpoint = [&](const CheckpointState &s) { checkpointRelay->post(s); };
+        std::string error;
+        if (!timingThread.start(rtConfig, error)) {
+            std::cerr << "Zamanlama iş parçacığı başlatılamadı: " << error << "\n";
+            return 1;
         }
-
+        controller.timing = &timingThread;
+        const RtThread &rt = timingThread.rt();
+        std::cout << "Zamanlama iş parçacığı: " << rt_policy_name(rt.policy) << " öncelik " << rt.priority << ", çekirdek " << rt.cpu << "\n";
     }
-
+    std::cout << "Komut giriniz: " << std::flush;
+
+#ifdef JUNCTION_HEAP_GUARD
+    heap_guard::on_violation = heap_guard::report_first;
+    heap_guard::seal();
+#endif
+    loop.run();
+#ifdef JUNCTION_HEAP_GUARD
+    heap_guard::unseal();
+    std::cerr << "heap_guard: başlangıçtan sonra " << heap_guard::after_seal.load() << " bellek ayırması\n";
+#endif
+
+    // Zamanlama iş parçacığı durduktan sonra kuyrukta kalan geçişler ve son durum dosyalara yazılır.
+    auto drain_relays = [&] {
+        if (eventLogRelay) eventLogRelay->drain();
+        if (checkpointRelay) checkpointRelay->drain();
+    };
+    if (handover) {
+        timingThread.stop();
+        drain_relays();
+        std::cout << "Devir: ışıklar yanık bırakıldı, durum " << state_path << " dosyasında.\n";
+        return 0;
+    }
+    controller.on_timing_thread([&] {
+        runner.set_heads(0, CAUSE_SHUTDOWN);
+        controller.publish_state();
+    });
+    timingThread.stop();
+    drain_relays();
+    checkpoint.close_clean();
+    shmState.close_clean();
+    trace.close();
     return 0;
-}
\ No newline at end of file
+}
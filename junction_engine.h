@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "gpio_output.h"
+#include "signal_modes.h"
+#include "signal_plan.h"
+
+// Çok kavşaklı motor: yüzlerce kavşağı tek süreçten yürütür. Tüm durumlar, bitiş zamanları ve
+// planlar struct-of-arrays düzeninde ardışık dizilerde tutulur; advance() süresi dolan bütün
+// kavşakları tek geçişte ilerletir. Kavşaklar ModeRunner ile aynı derlenmiş plan tablolarını
+// (SignalPlan) yürütür; SEQUENCE, PHASE ve FLASH planları aynı sıra ve sürelerden bir kez derlenir,
+// dosyadan yüklenen planlar doğrudan verilir. ModeRunner'dan farkları: dedektör yoktur (değişken
+// yeşil rastgele seçilir), mod değişimi sarı ve tüm kırmızı ara adımları olmadan ilk adımdan başlar
+// ve çakışma denetimi yapılmaz; çıkışlar donanıma çağıran tarafından yazılır.
+class JunctionEngine {
+public:
+    static constexpr int64_t NEVER = std::numeric_limits<int64_t>::max();
+
+    int sequence_green = 5;             // saniye; ModeRunner varsayılanları
+    int phase_green_min = 3;
+    int phase_green_max = 10;
+
+    // Yeni kavşak ekler ve ilk adımını now_ns zamanında başlatır. Kavşak indeksini döndürür.
+    uint32_t add_junction(Mode m, const std::vector<int> &order, int head_count, int64_t now_ns, uint32_t seed = 1) {
+        return add_junction(m, builtin_plan(m, order, head_count), now_ns, seed);
+    }
+
+    // Dosyadan yüklenen plan; plan motordan uzun yaşamalıdır.
+    uint32_t add_junction(const SignalPlan &p, int64_t now_ns, uint32_t seed = 1) {
+        return add_junction(Mode::PLAN, &p, now_ns, seed);
+    }
+
+    void set_mode(uint32_t j, Mode m, const std::vector<int> &order, int head_count, int64_t now_ns) {
+        set_plan(j, m, builtin_plan(m, order, head_count), now_ns);
+    }
+
+    void set_plan(uint32_t j, const SignalPlan &p, int64_t now_ns) { set_plan(j, Mode::PLAN, &p, now_ns); }
+
+    // now_ns zamanına kadar süresi dolan bütün kavşakları ilerletir. Çıkışı değişen kavşaklar
+    // changed listesine eklenir; çağıran bunları toplu olarak donanıma ya da genişletici kartlara yazar.
+    size_t advance(int64_t now_ns) {
+        changed.clear();
+        if (now_ns < earliest) return 0;        // hiçbir kavşağın sırası gelmedi
+        int64_t next = NEVER;
+        size_t steps = 0;
+        const size_t n = deadline.size();
+        for (size_t j = 0; j < n; ++j) {
+            if (deadline[j] <= now_ns) {
+                OutputMask before = outputs[j];
+                while (deadline[j] <= now_ns) {     // geride kalan adımlar da yakalanır
+                    if (++step[j] == plan[j]->steps.size()) step[j] = 0;
+                    enter((uint32_t)j);
+                    ++steps;
+                }
+                if (outputs[j] != before) changed.push_back((uint32_t)j);
+            }
+            next = std::min(next, deadline[j]);
+        }
+        earliest = next;
+        return steps;
+    }
+
+    int64_t next_deadline() const { return earliest; }
+    size_t size() const { return mode.size(); }
+
+    // Struct-of-arrays durum. İndeks kavşak numarasıdır.
+    std::vector<uint8_t> mode;
+    std::vector<const SignalPlan *> plan;   // NONE ya da boş planda nullptr
+    std::vector<uint8_t> step;              // plandaki adım (en çok MAX_PLAN_STEPS)
+    std::vector<uint32_t> rng;              // değişken yeşil süreleri için xorshift durumu
+    std::vector<OutputMask> outputs;
+    std::vector<int64_t> deadline;          // adımın bitiş zamanı (ns)
+    std::vector<uint32_t> changed;          // son advance() çağrısında çıkışı değişen kavşaklar
+
+private:
+    // Yerleşik planlar mod, sıra ve kafa sayısına göre bir kez derlenir; aynı sıradaki kavşaklar
+    // aynı tabloyu paylaşır. deque eklemede adresleri korur.
+    struct BuiltinPlan {
+        Mode mode;
+        int head_count;
+        std::vector<int> order;
+        SignalPlan plan;
+    };
+
+    const SignalPlan *builtin_plan(Mode m, const std::vector<int> &order, int head_count) {
+        if (m != Mode::SEQUENCE && m != Mode::PHASE && m != Mode::FLASH) return nullptr;
+        for (const BuiltinPlan &b : builtins) {
+            if (b.mode == m && b.head_count == head_count && (m == Mode::FLASH || b.order == order)) return &b.plan;
+        }
+        SignalPlan p = m == Mode::FLASH      ? flash_plan(head_count)
+                       : m == Mode::PHASE    ? order_plan("PHASE", order.data(), order.size(), head_count, phase_green_min, phase_green_max)
+                                             : order_plan("SEQUENCE", order.data(), order.size(), head_count, sequence_green, sequence_green);
+        builtins.push_back({m, head_count, order, p});
+        return &builtins.back().plan;
+    }
+
+    uint32_t add_junction(Mode m, const SignalPlan *p, int64_t now_ns, uint32_t seed) {
+        uint32_t j = (uint32_t)mode.size();
+        mode.push_back((uint8_t)m);
+        plan.push_back(nullptr);
+        step.push_back(0);
+        rng.push_back(seed ? seed : 1);
+        outputs.push_back(0);
+        deadline.push_back(now_ns);
+        set_plan(j, m, p, now_ns);
+        return j;
+    }
+
+    void set_plan(uint32_t j, Mode m, const SignalPlan *p, int64_t now_ns) {
+        mode[j] = (uint8_t)m;
+        plan[j] = p && !p->steps.empty() ? p : nullptr;
+        step[j] = 0;
+        deadline[j] = now_ns;
+        enter(j);
+        earliest = std::min(earliest, deadline[j]);
+    }
+
+    // Adımın çıkışını yazar ve bitiş zamanını bir önceki bitişten hesaplar (kayma birikmez).
+    // Değişken adımın süresi PlanExecutor gibi tam saniyelerle min-max arasından seçilir.
+    void enter(uint32_t j) {
+        if (!plan[j]) {
+            outputs[j] = 0;
+            deadline[j] = NEVER;
+            return;
+        }
+        const PlanStep &s = plan[j]->steps[step[j]];
+        uint32_t ms = s.min_ms;
+        if (s.max_ms != s.min_ms) {
+            uint32_t x = rng[j];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            rng[j] = x;
+            ms += x % ((s.max_ms - s.min_ms) / 1000 + 1) * 1000;
+        }
+        outputs[j] = s.outputs;
+        deadline[j] += int64_t(ms) * 1000000;
+    }
+
+    std::deque<BuiltinPlan> builtins;
+    int64_t earliest = NEVER;
+};
@@ -0,0 +1,49 @@
+// Çok kavşaklı motorun ölçeklenme testi: 1, 100 ve 10 000 kavşağı sanal zamanda 100 ms'lik
+// adımlarla yürütür ve simüle edilen her saniye için harcanan CPU süresini raporlar.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target junction_engine_bench
+// Kullanım: junction_engine_bench [simüle_saniye]
+
+#include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "junction_engine.h"
+
+static double cpu_seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    int sim_seconds = argc > 1 ? std::atoi(argv[1]) : 3600;
+    const int64_t tick_ns = 100000000;      // 100 ms
+    const size_t sizes[] = {1, 100, 10000};
+
+    std::printf("junctions,sim_seconds,steps,cpu_ms,cpu_us_per_sim_second,ns_per_step\n");
+    for (size_t n : sizes) {
+        JunctionEngine engine;
+        const std::vector<int> order = {0, 1, 2, 3};
+        for (size_t j = 0; j < n; ++j) {
+            Mode m = (j % 10 == 9) ? Mode::FLASH : (j % 2 ? Mode::PHASE : Mode::SEQUENCE);
+            // Başlangıçlar kaydırılır ki bütün kavşaklar aynı anda geçiş yapmasın.
+            engine.add_junction(m, order, 4, int64_t(j % 90) * tick_ns, (uint32_t)j + 1);
+        }
+
+        size_t steps = 0;
+        unsigned long changed = 0;
+        double start = cpu_seconds();
+        for (int64_t now = 0; now <= int64_t(sim_seconds) * 1000000000; now += tick_ns) {
+            steps += engine.advance(now);
+            changed += engine.changed.size();
+        }
+        double cpu = cpu_seconds() - start;
+
+        std::printf("%zu,%d,%zu,%.3f,%.3f,%.1f\n", n, sim_seconds, steps, cpu * 1e3, cpu * 1e6 / sim_seconds,
+                    steps ? cpu * 1e9 / steps : 0.0);
+        if (changed == 0) return 1;     // motor hiç ilerlemediyse ölçüm geçersizdir
+    }
+    return 0;
+}
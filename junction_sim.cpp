@@ -0,0 +1,166 @@
+// Donanımsız simülasyon: kontrolcü modlarını sanal saat ve simülasyon arka ucuyla
+// gerçek zamandan çok daha hızlı çalıştırır. 24 saatlik bir döngü planı milisaniyeler içinde biter.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target junction_sim
+// Kullanım: junction_sim [--mode SEQUENCE|FLASH|PHASE] [--hours 24] [--dump]
+//                        [--demand 600,300,150,100 [--actuated] [--max-green 10] [--seed 1]] [--plans FILE]
+//
+// --demand yaklaşım başına saatlik araç sayısıyla trafik ve dedektör simülasyonunu açar; --actuated PHASE
+// yeşil sürelerini rastgele seçmek yerine dedektörlerden belirler. İki çalıştırmanın araç/saat ve çevrim
+// başına geçen araç sayıları karşılaştırılabilir. --plans ile yüklenen planlar --mode PLANADI ile çalıştırılır.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "clock.h"
+#include "mode_runner.h"
+#include "pin_map.h"
+#include "sim_backend.h"
+#include "sim_traffic.h"
+
+int main(int argc, char **argv) {
+    std::string mode = "SEQUENCE";
+    double hours = 24;
+    bool dump = false;
+    std::vector<double> demand;
+    bool actuated = false;
+    int max_green = 10;
+    unsigned seed = 1;
+    const char *plan_file = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--mode") == 0 && i + 1 < argc) mode = argv[++i];
+        else if (std::strcmp(argv[i], "--hours") == 0 && i + 1 < argc) hours = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--dump") == 0) dump = true;
+        else if (std::strcmp(argv[i], "--demand") == 0 && i + 1 < argc) {
+            for (char *p = argv[++i]; *p;) {
+                demand.push_back(std::strtod(p, &p));
+                if (*p == ',') ++p;
+                else if (*p) break;
+            }
+        } else if (std::strcmp(argv[i], "--actuated") == 0) actuated = true;
+        else if (std::strcmp(argv[i], "--max-green") == 0 && i + 1 < argc) max_green = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--plans") == 0 && i + 1 < argc) plan_file = argv[++i];
+        else {
+            std::cerr << "Kullanım: " << argv[0] << " [--mode SEQUENCE|FLASH|PHASE] [--hours 24] [--dump]"
+                      << " [--demand V1,V2,V3,V4 [--actuated] [--max-green S] [--seed N]] [--plans FILE]\n";
+            return 1;
+        }
+    }
+    std::vector<SignalPlan> plans;
+    if (plan_file) {
+        std::string error;
+        if (!load_plan_file(plan_file, plans, error)) {
+            std::cerr << "Plan dosyası hatalı: " << error << "\n";
+            return 1;
+        }
+    }
+    Mode m = parse_mode(mode);
+    int heads = HEAD_COUNT;
+    for (const SignalPlan &p : plans) {
+        if (m == Mode::NONE && p.name == mode) heads = p.groups;
+    }
+    if (!demand.empty() && (int)demand.size() != heads) {
+        std::cerr << "--demand için " << heads << " yaklaşım değeri gerekli\n";
+        return 1;
+    }
+
+    VirtualClock clock;
+    VirtualTimer timer(clock);
+    SimBackend backend(clock);
+    backend.record = dump;
+    // Pin haritası 4 kafalıdır; daha büyük planlar için her çipte 32 hat olan sanal bir harita kurulur.
+    std::vector<OutputPin> pins = default_pins();
+    if (heads != HEAD_COUNT) {
+        pins.clear();
+        for (int bit = 0; bit < heads * BITS_PER_HEAD; ++bit) pins.push_back({bit / 32, bit % 32});
+    }
+    JunctionOutput out(backend, pins);
+    out.init(0);
+    ModeRunner runner(out, clock, timer, heads);
+    runner.exec.gen.seed(seed);
+    runner.phase_green_max = max_green;
+    runner.rebuild_plans();
+    runner.plans = std::move(plans);
+
+    DetectorBank detectors(heads);
+    ActuatedTiming timing{detectors};
+    std::unique_ptr<SimTraffic> traffic;
+    if (!demand.empty()) traffic = std::make_unique<SimTraffic>(clock, out, detectors, demand, seed);
+    if (actuated) runner.actuation = &timing;
+
+    // Her kafanın her durumda geçirdiği süre: son geçişten bu yana geçen süre, o geçişin yazdığı maskeye
+    // eklenir. Maske ve zaman adım uygulandıktan sonra alınır.
+    double state_seconds[MAX_GROUPS][8] = {};
+    OutputMask last_mask = 0;
+    Clock::time_point last_time = clock.now();
+    auto account = [&] {
+        double dt = std::chrono::duration<double>(clock.now() - last_time).count();
+        for (int h = 0; h < heads; ++h) {
+            state_seconds[h][get_head(last_mask, h)] += dt;
+        }
+    };
+    auto mark = [&] {
+        last_mask = out.state();
+        last_time = clock.now();
+    };
+    timer.on_expire([&] {
+        account();
+        runner.next_step();
+        mark();
+    });
+
+    if (m == Mode::NONE && (runner.customPlan = runner.find_plan(mode))) m = Mode::PLAN;
+    if (m == Mode::NONE) {
+        std::cerr << "Bilinmeyen mod: " << mode << "\n";
+        return 1;
+    }
+    auto wall_start = std::chrono::steady_clock::now();
+    runner.start(m);
+    mark();
+    clock.run_until(clock.now() + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(hours * 3600)));
+    account();
+    auto wall = std::chrono::steady_clock::now() - wall_start;
+
+    if (dump) {
+        std::cout << "time_ms,chip,line,value\n";
+        for (const auto &c : backend.changes) {
+            std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(c.time.time_since_epoch()).count()
+                      << "," << c.chip << "," << c.offset << "," << c.value << "\n";
+        }
+    }
+
+    double wall_ms = std::chrono::duration<double, std::milli>(wall).count();
+    std::fprintf(stderr, "mod=%s simulasyon=%.1f saat gecis=%lu toplu_yazma=%lu\n", mode.c_str(), hours,
+                 out.transitions, backend.calls);
+    std::fprintf(stderr, "gercek_sure=%.3f ms gecis_basina=%.1f ns hizlanma=%.0fx\n", wall_ms,
+                 out.transitions ? wall_ms * 1e6 / out.transitions : 0.0, hours * 3600e3 / (wall_ms > 0 ? wall_ms : 1e-9));
+    for (int h = 0; h < heads; ++h) {
+        std::fprintf(stderr, "t%d: yesil=%.0fs sari=%.0fs kirmizi=%.0fs kirmizi+sari=%.0fs sonuk=%.0fs\n", h + 1,
+                     state_seconds[h][SIG_GREEN], state_seconds[h][SIG_YELLOW], state_seconds[h][SIG_RED],
+                     state_seconds[h][SIG_RED_YELLOW], state_seconds[h][SIG_OFF]);
+    }
+    if (traffic) {
+        unsigned long served = 0, queued = 0, cycles = 0;
+        double delay = 0;
+        for (int h = 0; h < heads; ++h) {
+            SimTraffic::Totals t = traffic->totals(h);
+            std::fprintf(stderr, "t%d: gelen=%lu gecen=%lu kuyruk=%lu ort_bekleme=%.1fs arac/yesil=%.2f dedektor_arac=%lu\n", h + 1,
+                         t.arrived, t.served, t.queued, t.served ? t.delay_seconds / t.served : 0.0,
+                         t.greens ? double(t.served) / t.greens : 0.0, detectors[h].vehicles);
+            served += t.served;
+            queued += t.queued;
+            delay += t.delay_seconds;
+            if (h == 0) cycles = t.greens;
+        }
+        std::fprintf(stderr, "zamanlama=%s gecen=%lu arac/saat=%.0f cevrim=%lu arac/cevrim=%.2f ort_bekleme=%.1fs kuyruk=%lu\n",
+                     actuated ? "actuated" : "sabit", served, served / hours, cycles, cycles ? double(served) / cycles : 0.0,
+                     served ? delay / served : 0.0, queued);
+    }
+    return 0;
+}
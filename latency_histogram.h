@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Sabit bellekli, HDR benzeri gecikme histogramı (nanosaniye). Her ikinin kuvveti aralığı 16 eşit
+// alt kovaya bölünür; bağıl hata %6'nın altındadır. Kayıt bir bit taraması ve bir artırmadır,
+// heap kullanılmaz. Tek yazıcı varsayılır (olay döngüsü).
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;                 // aralık başına alt kova
+    static constexpr int BUCKETS = (64 - SUB_BITS) * SUB_COUNT;     // 2^64 ns'ye kadar
+
+    void record(int64_t ns) {
+        uint64_t v = ns > 0 ? uint64_t(ns) : 0;
+        ++counts[index(v)];
+        if (total == 0 || v < min_ns) min_ns = v;
+        if (v > max_ns) max_ns = v;
+        sum_ns += v;
+        ++total;
+    }
+
+    void record(std::chrono::nanoseconds d) { record(int64_t(d.count())); }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return min_ns; }
+    uint64_t max() const { return max_ns; }
+    double mean() const { return total ? double(sum_ns) / total : 0.0; }
+
+    // p yüzdelik dilimine (0-100) düşen kovanın üst sınırı; gerçek en büyük değeri aşmaz.
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t target = uint64_t(p / 100.0 * total + 0.5);
+        if (target < 1) target = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                uint64_t upper = bucket_upper(i);
+                return upper < max_ns ? upper : max_ns;
+            }
+        }
+        return max_ns;
+    }
+
+    void reset() { *this = LatencyHistogram(); }
+
+private:
+    static int index(uint64_t v) {
+        if (v < 2 * SUB_COUNT) return int(v);
+        int shift = 63 - __builtin_clzll(v) - SUB_BITS;     // üst SUB_BITS+1 bit kalır
+        return (shift + 1) * SUB_COUNT + int((v >> shift) - SUB_COUNT);
+    }
+
+    static uint64_t bucket_upper(int i) {
+        if (i < 2 * SUB_COUNT) return uint64_t(i);
+        int shift = i / SUB_COUNT - 1;
+        uint64_t sub = uint64_t(i % SUB_COUNT + SUB_COUNT);
+        return ((sub + 1) << shift) - 1;
+    }
+
+    uint64_t counts[BUCKETS] = {};
+    uint64_t total = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t sum_ns = 0;
+};
@@ -0,0 +1,69 @@
+/*
+ * libgpiod v1 API'sinin kontrolcünün kullandığı alt kümesi için sahte uygulama. BeagleBone
+ * olmadan derlemek, ölçmek ve çalıştırmak içindir: çipler bellekte tutulur, hat istekleri ve
+ * toplu yazmalar gerçek kütüphanedeki gibi başarılı olur, değerler okunabilir. Dedektör
+ * olayları her hat için bir boru üzerinden gpiod_mock_inject_event ile üretilir.
+ *
+ * Gerçek libgpiod bulunamazsa CMake bu dizini kullanır (JUNCTION_MOCK_GPIOD).
+ */
+#pragma once
+
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct gpiod_chip;
+struct gpiod_line;
+
+#define GPIOD_LINE_BULK_MAX_LINES 64
+
+struct gpiod_line_bulk {
+    struct gpiod_line *lines[GPIOD_LINE_BULK_MAX_LINES];
+    unsigned int num_lines;
+};
+
+#define GPIOD_LINE_BULK_INITIALIZER { { NULL }, 0 }
+
+static inline void gpiod_line_bulk_init(struct gpiod_line_bulk *bulk) { bulk->num_lines = 0; }
+
+static inline void gpiod_line_bulk_add(struct gpiod_line_bulk *bulk, struct gpiod_line *line) {
+    bulk->lines[bulk->num_lines++] = line;
+}
+
+enum {
+    GPIOD_LINE_EVENT_RISING_EDGE = 1,
+    GPIOD_LINE_EVENT_FALLING_EDGE,
+};
+
+struct gpiod_line_event {
+    struct timespec ts;
+    int event_type;
+};
+
+struct gpiod_chip *gpiod_chip_open_by_name(const char *name);
+void gpiod_chip_close(struct gpiod_chip *chip);
+struct gpiod_line *gpiod_chip_get_line(struct gpiod_chip *chip, unsigned int offset);
+
+int gpiod_line_request_output(struct gpiod_line *line, const char *consumer, int default_val);
+int gpiod_line_request_bulk_output(struct gpiod_line_bulk *bulk, const char *consumer, const int *default_vals);
+int gpiod_line_set_value(struct gpiod_line *line, int value);
+int gpiod_line_set_value_bulk(struct gpiod_line_bulk *bulk, const int *values);
+int gpiod_line_get_value(struct gpiod_line *line);
+int gpiod_line_get_value_bulk(struct gpiod_line_bulk *bulk, int *values);
+void gpiod_line_release(struct gpiod_line *line);
+void gpiod_line_release_bulk(struct gpiod_line_bulk *bulk);
+
+int gpiod_line_request_both_edges_events(struct gpiod_line *line, const char *consumer);
+int gpiod_line_event_get_fd(struct gpiod_line *line);
+int gpiod_line_event_read_fd_multiple(int fd, struct gpiod_line_event *events, unsigned int num_events);
+
+/* Yalnızca sahte kütüphanede bulunur. */
+int gpiod_mock_inject_event(unsigned int chip, unsigned int offset, int rising);
+int gpiod_mock_value(unsigned int chip, unsigned int offset);
+unsigned long gpiod_mock_set_calls(void);
+
+#ifdef __cplusplus
+}
+#endif
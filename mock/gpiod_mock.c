@@ -0,0 +1,144 @@
+/*
+ * Sahte libgpiod. Hat değerleri serbest bırakıldıktan sonra korunur; gerçek donanımda da çıkış
+ * hattı bırakıldığında son değerinde kalır, sıcak yeniden başlatma bu davranışa dayanır.
+ */
+#define _GNU_SOURCE
+#include "gpiod.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MOCK_CHIPS 8
+#define MOCK_LINES 64
+
+struct gpiod_line {
+    struct gpiod_chip *chip;
+    unsigned int offset;
+    int requested;
+    int value;
+    int event_fd[2];
+};
+
+struct gpiod_chip {
+    struct gpiod_line lines[MOCK_LINES];
+};
+
+static struct gpiod_chip chips[MOCK_CHIPS];
+static unsigned long set_calls;
+
+struct gpiod_chip *gpiod_chip_open_by_name(const char *name) {
+    unsigned int n;
+    char tail;
+    if (sscanf(name, "gpiochip%u%c", &n, &tail) != 1 || n >= MOCK_CHIPS) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return &chips[n];
+}
+
+void gpiod_chip_close(struct gpiod_chip *chip) { (void)chip; }
+
+struct gpiod_line *gpiod_chip_get_line(struct gpiod_chip *chip, unsigned int offset) {
+    if (!chip || offset >= MOCK_LINES) {
+        errno = EINVAL;
+        return NULL;
+    }
+    struct gpiod_line *line = &chip->lines[offset];
+    line->chip = chip;
+    line->offset = offset;
+    return line;
+}
+
+int gpiod_line_request_output(struct gpiod_line *line, const char *consumer, int default_val) {
+    struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+    gpiod_line_bulk_add(&bulk, line);
+    return gpiod_line_request_bulk_output(&bulk, consumer, &default_val);
+}
+
+int gpiod_line_request_bulk_output(struct gpiod_line_bulk *bulk, const char *consumer, const int *default_vals) {
+    (void)consumer;
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        if (bulk->lines[i]->requested) {
+            errno = EBUSY;
+            return -1;
+        }
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        bulk->lines[i]->requested = 1;
+        bulk->lines[i]->value = default_vals ? default_vals[i] : 0;
+    }
+    return 0;
+}
+
+int gpiod_line_set_value(struct gpiod_line *line, int value) {
+    line->value = value;
+    ++set_calls;
+    return 0;
+}
+
+int gpiod_line_set_value_bulk(struct gpiod_line_bulk *bulk, const int *values) {
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) bulk->lines[i]->value = values[i];
+    ++set_calls;
+    return 0;
+}
+
+int gpiod_line_get_value(struct gpiod_line *line) { return line->value; }
+
+int gpiod_line_get_value_bulk(struct gpiod_line_bulk *bulk, int *values) {
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) values[i] = bulk->lines[i]->value;
+    return 0;
+}
+
+void gpiod_line_release(struct gpiod_line *line) {
+    if (!line || !line->requested) return;
+    line->requested = 0;
+    if (line->event_fd[0] > 0) {
+        close(line->event_fd[0]);
+        close(line->event_fd[1]);
+        line->event_fd[0] = line->event_fd[1] = 0;
+    }
+}
+
+void gpiod_line_release_bulk(struct gpiod_line_bulk *bulk) {
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) gpiod_line_release(bulk->lines[i]);
+}
+
+int gpiod_line_request_both_edges_events(struct gpiod_line *line, const char *consumer) {
+    (void)consumer;
+    if (line->requested) {
+        errno = EBUSY;
+        return -1;
+    }
+    if (pipe2(line->event_fd, O_CLOEXEC) != 0) return -1;
+    line->requested = 1;
+    return 0;
+}
+
+int gpiod_line_event_get_fd(struct gpiod_line *line) { return line->event_fd[0] > 0 ? line->event_fd[0] : -1; }
+
+int gpiod_line_event_read_fd_multiple(int fd, struct gpiod_line_event *events, unsigned int num_events) {
+    ssize_t n = read(fd, events, num_events * sizeof(*events));
+    if (n < 0) return -1;
+    return (int)(n / (ssize_t)sizeof(*events));
+}
+
+int gpiod_mock_inject_event(unsigned int chip, unsigned int offset, int rising) {
+    if (chip >= MOCK_CHIPS || offset >= MOCK_LINES) return -1;
+    struct gpiod_line *line = &chips[chip].lines[offset];
+    if (line->event_fd[1] <= 0) return -1;
+    struct gpiod_line_event ev;
+    clock_gettime(CLOCK_MONOTONIC, &ev.ts);
+    ev.event_type = rising ? GPIOD_LINE_EVENT_RISING_EDGE : GPIOD_LINE_EVENT_FALLING_EDGE;
+    return write(line->event_fd[1], &ev, sizeof(ev)) == (ssize_t)sizeof(ev) ? 0 : -1;
+}
+
+int gpiod_mock_value(unsigned int chip, unsigned int offset) {
+    if (chip >= MOCK_CHIPS || offset >= MOCK_LINES) return -1;
+    return chips[chip].lines[offset].value;
+}
+
+unsigned long gpiod_mock_set_calls(void) { return set_calls; }
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "actuated_timing.h"
+#include "clock.h"
+#include "gpio_output.h"
+#include "latency_histogram.h"
+#include "plan_swap.h"
+#include "signal_modes.h"
+#include "signal_plan.h"
+
+// Aktif planın adımlarını mutlak bitiş zamanlarına göre yürütür. Her adımın bitişi bir öncekinin
+// bitişine eklenir, böylece döngü yükü birikmez. Mod değişikliği hemen başlar; yanan yeşiller önce
+// sarı ve tüm kırmızı ara adımlarıyla kapatılır, yeni plan kırmızı+sarı ile girilir.
+// Saat ve zamanlayıcı dışarıdan verilir: gerçek çalışmada timerfd, simülasyonda sanal saat.
+// SEQUENCE, PHASE ve FLASH da birer plandır; sıra değişince yalnızca ilgili plan yeniden derlenir.
+// Yürütücü her zaman planın değişmez bir sürümünü çalıştırır; çalışan plandaki sıra değişikliği yeni
+// bir sürüm olarak yayımlanır ve bir sonraki güvenli sınırda (kırmızı+sarı sonu) devralınır.
+struct ModeRunner {
+    JunctionOutput &out;
+    Clock &clock;
+    DeadlineTimer &timer;
+    int head_count;
+    Mode mode = Mode::NONE;
+    PlanExecutor exec;
+    Clock::time_point deadline;
+    GroupOrder phaseOrder;              // Phase modu için faz sırası (t1-t2-t3-t4)
+    GroupOrder sequenceOrder;
+    int sequence_green = 5;             // saniye
+    int phase_green_min = 3;            // PHASE yeşili bu aralıkta seçilir ya da dedektörle belirlenir
+    int phase_green_max = 10;
+    SignalPlan sequencePlan, phasePlan, flashPlan;
+    std::vector<SignalPlan> plans;      // dosyadan yüklenen planlar (Mode::PLAN)
+    const SignalPlan *customPlan = nullptr;
+    LatencyHistogram step_lateness;     // adımın planlanan bitişi ile gerçekleştiği an arasındaki fark
+    const ActuatedTiming *actuation = nullptr;  // verilirse değişken yeşiller dedektörlerden belirlenir
+    Clock::time_point green_start;
+    PlanVersionPool versions;                   // swap ve sürüm işaretçilerinden önce kurulur, sonra yok edilir
+    PlanSwap swap;                              // çalışan modun yeni sürümleri
+    PlanVersionPtr running;                     // exec.plan bu sürümü gösterir
+    PlanVersionPtr waiting;                     // alınmış, uygun sınırı beklenen sürüm
+    uint64_t plan_version = 0;
+    unsigned safe_points_waited = 0;
+    LatencyHistogram swap_latency;              // sürümün yayımlanmasından devralınmasına kadar geçen süre
+    unsigned long swaps = 0;
+    std::function<void()> on_fault;     // çakışma nedeniyle FLASH'a geçildiğinde çağrılır
+    std::function<void()> on_change;    // adım, bitiş zamanı ya da mod değiştiğinde çağrılır (durum kaydı)
+    bool faulting = false;
+    uint32_t clearance_yellow_ms = 2000;        // mod değişiminde yeşilden sonraki sarı
+    uint32_t clearance_red_ms = 1000;           // en kısa tüm kırmızı; çakışma ara süresi daha uzunsa o kadar
+    InlineVector<PlanStep, 3> clearance;        // yeni plana girmeden önceki ara adımlar
+    size_t clearing = 0;                        // clearance içindeki adım; clearance.size() ise plandadır
+
+    ModeRunner(JunctionOutput &out, Clock &clock, DeadlineTimer &timer, int head_count)
+        : out(out), clock(clock), timer(timer), head_count(head_count) {
+        for (int i = 0; i < head_count; ++i) {
+            phaseOrder.push_back(i);
+            sequenceOrder.push_back(i);
+        }
+        rebuild_plans();
+        timer.on_expire([this] { next_step(); });
+    }
+
+    void rebuild_plans() {
+        sequencePlan = order_plan("SEQUENCE", sequenceOrder.data(), sequenceOrder.size(), head_count, sequence_green, sequence_green);
+        phasePlan = order_plan("PHASE", phaseOrder.data(), phaseOrder.size(), head_count, phase_green_min, phase_green_max);
+        flashPlan = flash_plan(head_count);
+    }
+
+    // Sıra değişince ilgili plan derlenir. Plan o anda çalışıyorsa yeni sürüm yayımlanır ve true döner;
+    // bound verilirse sürümün en geç ne kadar sonra devralınacağı yazılır. Çevrim baştan başlamaz.
+    bool set_order(Mode m, const int *order, int count, Clock::duration *bound = nullptr) {
+        GroupOrder &o = m == Mode::PHASE ? phaseOrder : sequenceOrder;
+        o.assign(order, order + count);
+        rebuild_plans();
+        if (mode != m || !exec.running()) return false;
+        const SignalPlan &next = *plan_for(m);
+        if (bound) *bound = swap_bound(next);
+        swap.publish(versions.acquire(next, ++plan_version, clock.now()));
+        return true;
+    }
+
+    // Çalışan plandaki güvenli adımdan sonra yeni planda devam edilecek adım: aynı çıkışlı güvenli
+    // adımın ardılı. Sıra değişikliklerinde her kırmızı+sarı adımının karşılığı vardır. Yoksa -1.
+    static int swap_entry(const PlanStep &at, const SignalPlan &next) {
+        for (size_t k = 0; k < next.steps.size(); ++k) {
+            const PlanStep &s = next.steps[k];
+            if ((s.flags & STEP_SAFE_POINT) && s.outputs == at.outputs) return int((k + 1) % next.steps.size());
+        }
+        return -1;
+    }
+
+    static unsigned count_safe(const SignalPlan &p) {
+        unsigned n = 0;
+        for (const PlanStep &s : p.steps) n += s.flags & STEP_SAFE_POINT;
+        return n;
+    }
+
+    // Yeni sürümün en geç devralınacağı ana kalan süre. Değişken adımlar en uzun süreleriyle sayılır.
+    Clock::duration swap_bound(const SignalPlan &next) const {
+        const SignalPlan &p = *exec.plan;
+        size_t n = p.steps.size(), i = exec.index;
+        unsigned safe = count_safe(p), seen = 0;
+        Clock::duration t = deadline - clock.now();
+        for (size_t k = 0; k <= 2 * n; ++k) {
+            if ((p.steps[i].flags & STEP_SAFE_POINT) && (swap_entry(p.steps[i], next) >= 0 || ++seen > safe)) break;
+            i = (i + 1) % n;
+            t += std::chrono::milliseconds(p.steps[i].max_ms);
+        }
+        return t;
+    }
+
+    // Mod değişiminde planın değişmez bir kopyası yürütülür; bekleyen sürümler geçersizdir.
+    void run_plan(const SignalPlan *p) {
+        PlanVersionPool::release(swap.take());
+        waiting.reset();
+        running.reset();
+        if (p && !p->steps.empty()) running.reset(versions.acquire(*p, plan_version, clock.now()));
+        exec.start(running ? &running->plan : nullptr);
+        clearance.clear();
+        clearing = 0;
+    }
+
+    // Yeni planın ilk adımında yeşil varsa ve ışıklar o adımda değilse ara adımlar kurulur: yeşil ve
+    // sarı kafalar sarıya, sonra bütün kafalar kırmızıya geçer, ilk adımın yeşilleri planın kendi
+    // kırmızı+sarı adımıyla başlar. Tüm kırmızı, çakışma denetiminin ara süresi ilk yeşile kadar dolacak
+    // kadar uzatılır. Karanlık kavşaktan (açılış, CLOSE) ve yeşilsiz planlara (FLASH) doğrudan geçilir.
+    void plan_clearance(Mode from) {
+        if (!exec.running()) return;
+        const SignalPlan &p = *exec.plan;
+        OutputMask shown = out.state() & heads_mask(), first = p.steps[0].outputs, before = p.steps.back().outputs;
+        OutputMask yellow = all_heads(head_count, SIG_RED), red = yellow, red_yellow = yellow;
+        bool first_green = false, any_yellow = false, any_red_yellow = false;
+        for (int g = 0; g < head_count; ++g) {
+            unsigned sig = get_head(shown, g);
+            if (sig == SIG_GREEN || sig == SIG_YELLOW) {
+                yellow = set_head(yellow, g, SIG_YELLOW);
+                any_yellow = true;
+            }
+            if (get_head(first, g) != SIG_GREEN) continue;
+            first_green = true;
+            if (get_head(before, g) == SIG_RED_YELLOW) {
+                red_yellow = set_head(red_yellow, g, SIG_RED_YELLOW);
+                any_red_yellow = true;
+            }
+        }
+        if ((!shown && from == Mode::NONE) || !first_green || shown == first) return;
+        uint32_t yellow_ms = any_yellow ? clearance_yellow_ms : 0;
+        uint32_t red_yellow_ms = any_red_yellow ? p.steps.back().min_ms : 0;
+        uint32_t red_ms = clearance_red_ms;
+        if (out.monitor) {
+            long long need = std::chrono::duration_cast<std::chrono::milliseconds>(out.monitor->clearance(clock.now())).count();
+            if (need - yellow_ms - red_yellow_ms > red_ms) red_ms = uint32_t(need - yellow_ms - red_yellow_ms);
+        }
+        if (any_yellow) clearance.push_back({yellow, yellow_ms, yellow_ms, -1, 0});
+        clearance.push_back({red, red_ms, red_ms, -1, 0});
+        if (any_red_yellow) clearance.push_back({red_yellow, red_yellow_ms, red_yellow_ms, -1, 0});
+    }
+
+    bool clearing_now() const { return clearing < clearance.size(); }
+
+    const PlanStep &current_step() const { return clearing_now() ? clearance[clearing] : exec.current(); }
+
+    // Güvenli sınırda bekleyen sürüm devralınır. Uygun adım bulunamazsa bir çevrim boyunca sonraki
+    // güvenli sınırlar denenir; sonra yeni plan baştan başlar (çakışma denetimi yine geçerlidir).
+    bool adopt_pending() {
+        if (PlanVersion *v = swap.take()) {
+            swap.retire(waiting.release());
+            waiting.reset(v);
+            safe_points_waited = 0;
+        }
+        if (!waiting) return false;
+        int next = swap_entry(exec.current(), waiting->plan);
+        if (next < 0 && ++safe_points_waited <= count_safe(running->plan)) return false;
+        swap_latency.record(clock.now() - waiting->published);
+        ++swaps;
+        swap.retire(running.release());
+        running = std::move(waiting);
+        exec.plan = &running->plan;
+        exec.index = next < 0 ? 0 : next;
+        return true;
+    }
+
+    const SignalPlan *find_plan(std::string_view name) const {
+        for (const SignalPlan &p : plans) {
+            if (p.name == name) return &p;
+        }
+        return nullptr;
+    }
+
+    const SignalPlan *plan_for(Mode m) const {
+        switch (m) {
+            case Mode::SEQUENCE: return &sequencePlan;
+            case Mode::PHASE: return &phasePlan;
+            case Mode::FLASH: return &flashPlan;
+            case Mode::PLAN: return customPlan;
+            default: return nullptr;
+        }
+    }
+
+    OutputMask heads_mask() const { return (OutputMask(1) << (head_count * BITS_PER_HEAD)) - 1; }
+
+    // Kafa dışındaki çıkışlar (durum LED'i gibi) korunur, kafalar tek commit ile değişir.
+    bool set_heads(OutputMask heads, uint8_t cause = CAUSE_STEP) {
+        return out.commit((out.state() & ~heads_mask()) | (heads & heads_mask()), cause);
+    }
+
+    // Çakışma denetimi bir adımı reddetti: ışıklar eski durumda kalır ve hemen FLASH'a geçilir.
+    // FLASH'ta yeşil olmadığından bu geçiş reddedilemez.
+    void enter_fault() {
+        if (faulting) {         // FLASH da reddedildiyse çıkışlara dokunulmaz
+            timer.disarm();
+            return;
+        }
+        faulting = true;
+        mode = Mode::FLASH;
+        run_plan(&flashPlan);
+        out.mode_tag = (uint8_t)Mode::FLASH;
+        deadline = clock.now();
+        apply(CAUSE_CONFLICT);
+        faulting = false;
+        if (on_fault) on_fault();
+    }
+
+    void start(Mode m, uint8_t cause = CAUSE_MODE_CHANGE) {
+        Mode from = mode;
+        mode = m;
+        run_plan(plan_for(m));
+        out.mode_tag = (uint8_t)m;
+        deadline = clock.now();
+        plan_clearance(from);
+        apply(cause);
+    }
+
+    // Sıcak yeniden başlatma: plan, adım ve bitiş zamanı kayıttan alınır. Çıkışlar zaten bu adımdadır,
+    // yazılmaz. Bitiş geçmişte kaldıysa kapalıyken kaçırılan adımlar oynatılmaz: ışıklar o ana kadar bu
+    // adımda kaldığından planın bir sonraki adımı şimdi, tam süresiyle başlar.
+    bool resume(Mode m, size_t step, Clock::time_point d, Clock::time_point gs) {
+        const SignalPlan *p = plan_for(m);
+        if (m == Mode::NONE || !p || step >= p->steps.size()) return false;
+        if ((out.state() & heads_mask()) != p->steps[step].outputs) return false;
+        mode = m;
+        run_plan(p);
+        exec.index = step;
+        out.mode_tag = (uint8_t)m;
+        deadline = d;
+        green_start = gs;
+        Clock::time_point now = clock.now();
+        if (deadline < now) deadline = now;
+        timer.arm_at(deadline);
+        return true;
+    }
+
+    void next_step() {
+        step_lateness.record(clock.now() - deadline);
+        if (clearing_now()) {
+            ++clearing;
+            apply(CAUSE_STEP);
+            return;
+        }
+        if (!exec.running() || extend_green()) return;
+        if (!(exec.current().flags & STEP_SAFE_POINT) || !adopt_pending()) exec.advance();
+        apply(CAUSE_STEP);
+    }
+
+    void apply(uint8_t cause) {
+        if (!exec.running()) {
+            set_heads(0, cause);
+            timer.disarm();
+            if (on_change) on_change();
+            return;
+        }
+        const PlanStep &s = current_step();
+        std::chrono::milliseconds duration;
+        if (clearing_now()) {
+            duration = std::chrono::milliseconds(s.min_ms);
+        } else if (actuated_green()) {     // rastgele süre yerine en kısa yeşil; gerisini talep belirler
+            duration = std::chrono::milliseconds(s.min_ms);
+            green_start = deadline;
+        } else {
+            duration = exec.duration();
+        }
+        if (!set_heads(s.outputs, cause)) {
+            enter_fault();
+            return;
+        }
+        deadline += duration;
+        timer.arm_at(deadline);
+        if (on_change) on_change();
+    }
+
+    bool actuated_green() const {
+        const PlanStep &s = exec.current();
+        return actuation && s.detector >= 0 && s.detector < actuation->detectors.size() && s.max_ms > s.min_ms;
+    }
+
+    // Talep sürüyorsa yeşilin bitişini ileri alır; kafalar değişmediği için GPIO'ya yazılmaz.
+    bool extend_green() {
+        if (!actuated_green()) return false;
+        const PlanStep &s = exec.current();
+        Clock::time_point end = actuation->green_end(s.detector, green_start, clock.now(), std::chrono::milliseconds(s.min_ms),
+                                                     std::chrono::milliseconds(s.max_ms));
+        if (end <= deadline) return false;
+        deadline = end;
+        timer.arm_at(deadline);
+        if (on_change) on_change();
+        return true;
+    }
+};
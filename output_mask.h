@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Kavşağın bütün çıkışları tek bir maskede tutulur. Her kafa 3 bit kullanır:
+// bit (3 * kafa + 0) kırmızı, (3 * kafa + 1) sarı, (3 * kafa + 2) yeşil.
+using OutputMask = uint64_t;
+
+enum Signal : unsigned {
+    SIG_OFF = 0,
+    SIG_RED = 1,
+    SIG_YELLOW = 2,
+    SIG_RED_YELLOW = 3,
+    SIG_GREEN = 4,
+};
+
+constexpr int BITS_PER_HEAD = 3;
+
+inline OutputMask set_head(OutputMask mask, int head, unsigned sig) {
+    int shift = head * BITS_PER_HEAD;
+    return (mask & ~(OutputMask(7) << shift)) | (OutputMask(sig & 7) << shift);
+}
+
+inline unsigned get_head(OutputMask mask, int head) {
+    return unsigned(mask >> (head * BITS_PER_HEAD)) & 7;
+}
+
+inline OutputMask all_heads(int head_count, unsigned sig) {        // tüm kafaları aynı duruma getiren maske
+    OutputMask mask = 0;
+    for (int i = 0; i < head_count; ++i) {
+        mask = set_head(mask, i, sig);
+    }
+    return mask;
+}
+
+inline const char *signal_name(unsigned sig) {
+    if ((sig & SIG_RED_YELLOW) == SIG_RED_YELLOW) return "RED+YELLOW";
+    if (sig & SIG_GREEN) return "GREEN";
+    if (sig & SIG_YELLOW) return "YELLOW";
+    if (sig & SIG_RED) return "RED";
+    return "OFF";
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gpio_output.h"
+
+constexpr int HEAD_COUNT = 4;
+constexpr int STATUS_LED_BIT = HEAD_COUNT * BITS_PER_HEAD;     // durum LED'i maskede kafalardan sonra gelir
+constexpr int MAX_HEADS = 16;       // 16 kafa ve durum LED'i 64 bitlik maskeye sığar
+
+// BeagleBone pin haritası, maskedeki bit sırasıyla: her kafa için kırmızı, sarı, yeşil; en sonda durum LED'i.
+inline std::vector<OutputPin> default_pins() {
+    return {
+        {1, 13}, {1, 12}, {0, 26},      // t1: P8_11, P8_12, P8_14
+        {1, 15}, {1, 14}, {0, 27},      // t2: P8_15, P8_16, P8_17
+        {2, 1},  {1, 29}, {1, 28},      // t3: P8_18, P8_26, P9_12
+        {1, 16}, {1, 17}, {3, 19},      // t4: P9_15, P9_23, P9_27
+        {1, 18},                        // durum LED'i: P9_14
+    };
+}
+
+struct DetectorPin {
+    int chip;
+    int offset;
+    int approach;       // dedektörün bağlı olduğu kafa (0 = t1)
+};
+
+// Duraklama çizgisi dedektörleri, her yaklaşım için bir giriş: P8_7, P8_8, P8_9, P8_10.
+inline std::vector<DetectorPin> default_detector_pins() {
+    return {
+        {2, 2, 0}, {2, 3, 1}, {2, 5, 2}, {2, 4, 3},
+    };
+}
+
+// Kavşağın pin yapılandırması: kafa sayısı, maskedeki bit sırasıyla çıkış hatları ve dedektörler.
+struct PinConfig {
+    int heads = 0;
+    bool status_led = false;
+    std::vector<OutputPin> pins;        // kafa başına kırmızı, sarı, yeşil; varsa en sonda durum LED'i
+    std::vector<DetectorPin> detectors;
+};
+
+inline PinConfig default_pin_config() {
+    PinConfig c;
+    c.heads = HEAD_COUNT;
+    c.status_led = true;
+    c.pins = default_pins();
+    c.detectors = default_detector_pins();
+    return c;
+}
+
+// "çip:hat" biçimindeki pin.
+inline bool parse_pin(const char *text, int &chip, int &offset) {
+    char *end;
+    chip = (int)std::strtol(text, &end, 10);
+    if (end == text || *end != ':') return false;
+    const char *p = end + 1;
+    offset = (int)std::strtol(p, &end, 10);
+    return end != p && *end == '\0' && chip >= 0 && offset >= 0;
+}
+
+// Pin dosyası. Her "head" satırı bir sinyal kafasıdır (t1, t2, ...); sıra maskedeki sıradır.
+//   head 1:13 1:12 0:26      kırmızı, sarı, yeşil
+//   led 1:18                 durum LED'i
+//   detector 1 2:2           t1 yaklaşımının dedektörü
+// Aynı hat iki kez kullanılamaz. Hatalar "dosya:satır: mesaj" biçiminde verilir.
+inline bool load_pin_file(const char *path, PinConfig &config, std::string &error) {
+    FILE *f = std::fopen(path, "r");
+    if (!f) return error = std::string(path) + ": açılamadı", false;
+    PinConfig c;
+    OutputPin led{-1, -1};
+    int lineno = 0;
+    char line[256];
+    auto fail = [&](const std::string &msg) {
+        std::fclose(f);
+        error = std::string(path) + ":" + std::to_string(lineno) + ": " + msg;
+        return false;
+    };
+    auto used = [&](int chip, int offset) {
+        for (const OutputPin &p : c.pins) {
+            if (p.chip == chip && p.offset == offset) return true;
+        }
+        for (const DetectorPin &d : c.detectors) {
+            if (d.chip == chip && d.offset == offset) return true;
+        }
+        return led.chip == chip && led.offset == offset;
+    };
+    while (std::fgets(line, sizeof(line), f)) {
+        ++lineno;
+        if (char *hash = std::strchr(line, '#')) *hash = '\0';
+        std::vector<char *> words;
+        for (char *tok = std::strtok(line, " \t\r\n"); tok; tok = std::strtok(nullptr, " \t\r\n")) words.push_back(tok);
+        if (words.empty()) continue;
+        if (std::strcmp(words[0], "head") == 0 && words.size() == 4) {
+            if (c.heads == MAX_HEADS) return fail("en fazla " + std::to_string(MAX_HEADS) + " kafa");
+            for (int i = 1; i <= 3; ++i) {
+                OutputPin p;
+                if (!parse_pin(words[i], p.chip, p.offset)) return fail(std::string("geçersiz pin: ") + words[i]);
+                if (used(p.chip, p.offset)) return fail(std::string("pin iki kez kullanılmış: ") + words[i]);
+                c.pins.push_back(p);
+            }
+            ++c.heads;
+        } else if (std::strcmp(words[0], "led") == 0 && words.size() == 2) {
+            OutputPin p;
+            if (!parse_pin(words[1], p.chip, p.offset)) return fail(std::string("geçersiz pin: ") + words[1]);
+            if (used(p.chip, p.offset)) return fail(std::string("pin iki kez kullanılmış: ") + words[1]);
+            led = p;
+        } else if (std::strcmp(words[0], "detector") == 0 && words.size() == 3) {
+            DetectorPin d;
+            d.approach = std::atoi(words[1]) - 1;
+            if (!parse_pin(words[2], d.chip, d.offset)) return fail(std::string("geçersiz pin: ") + words[2]);
+            if (used(d.chip, d.offset)) return fail(std::string("pin iki kez kullanılmış: ") + words[2]);
+            c.detectors.push_back(d);
+        } else {
+            return fail(std::string("bilinmeyen ya da eksik tanım: ") + words[0]);
+        }
+    }
+    std::fclose(f);
+    if (c.heads == 0) return error = std::string(path) + ": hiç kafa tanımlanmamış", false;
+    for (const DetectorPin &d : c.detectors) {
+        if (d.approach < 0 || d.approach >= c.heads) return error = std::string(path) + ": dedektör olmayan bir kafaya bağlı", false;
+    }
+    if (led.chip >= 0) {
+        c.pins.push_back(led);
+        c.status_led = true;
+    }
+    config = c;
+    return true;
+}
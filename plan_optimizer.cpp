@@ -0,0 +1,361 @@
+// Çevrimdışı sabit zamanlı plan eniyileyici. Yaklaşım başına saatlik araç sayısından kavşağın
+// aşamalarını (birlikte yeşil yanabilen gruplar), aşama sırasını, yeşil sürelerini ve çevrim süresini
+// arar; her adayı flow_sim.h'deki akışkan kuyruk modeliyle benzetir ve araç başına ortalama gecikmesi
+// en düşük planı plans.conf biçiminde yazar. Çıktı doğrudan `junction_control --plans` ile yüklenir
+// ve `SETMODE=PLANADI` ile seçilir.
+//
+// Aşamalar çakışma kurallarına (--rules: plans.conf biçiminde compatible/intergreen satırları) uyan
+// bütün bölüntülerden, sıralar bu aşamaların bütün dizilişlerinden üretilir; ara süre kuralını
+// bozan sıralar check_plan_conflicts ile elenir. Her (sıra, çevrim, ilk yeşil) üçlüsü bir görevdir ve
+// görevler bütün çekirdeklere iş çalan bir havuzla dağıtılır. İstatistikler standart hataya CSV olarak
+// yazılır.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target plan_optimizer
+// Kullanım: plan_optimizer --rates 600,300,500,200 [--saturation 1800] [--rules FILE] [--cycle 40-120]
+//                          [--cycle-step 2] [--min-green 5] [--max-green 60] [--split-step 1]
+//                          [--yellow 2] [--redyellow 2] [--max-saturation 0.9] [--horizon 900] [--threads N] [--name OPT] [--out FILE]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "conflict_monitor.h"
+#include "flow_sim.h"
+#include "signal_plan.h"
+#include "work_pool.h"
+
+static constexpr int MAX_STAGES = 8;
+
+struct Options {
+    std::vector<double> rates, saturation = {1800};
+    const char *rules_file = nullptr;
+    const char *out_file = nullptr;
+    std::string name = "OPT";
+    int cycle_min = 40, cycle_max = 120, cycle_step = 2;
+    int min_green = 5, max_green = 60, split_step = 1;
+    int yellow = 2, red_yellow = 2;
+    float max_saturation = 0.9f;
+    int horizon = 900;                  // HCM çözümleme süresi: yoğun 15 dakika
+    unsigned threads = std::thread::hardware_concurrency();
+};
+
+// Sıralı aşamalar; her grup tam olarak bir aşamada yeşil yanar.
+struct Structure {
+    std::vector<uint32_t> stages;
+};
+
+struct Task {
+    uint32_t structure;
+    uint16_t cycle;
+    uint16_t first_green;
+};
+
+struct Best {
+    float cost = std::numeric_limits<float>::infinity();
+    int structure = -1;
+    int cycle = 0;
+    int greens[MAX_STAGES] = {};
+};
+
+struct alignas(64) WorkerState {
+    FlowBatch batch;
+    int greens[FlowBatch::LANES][MAX_STAGES];
+    int filled = 0;
+    unsigned long evaluated = 0;
+    Best best;
+};
+
+static bool parse_list(const char *s, std::vector<double> &out) {
+    out.clear();
+    for (char *p = const_cast<char *>(s); *p;) {
+        out.push_back(std::strtod(p, &p));
+        if (*p == ',') ++p;
+        else if (*p) return false;
+    }
+    return !out.empty();
+}
+
+// Grupları, her bloğundaki gruplar birbiriyle çakışmayacak şekilde bütün bölüntülere ayırır.
+static void partitions(const ConflictRules &rules, int g, std::vector<uint32_t> &blocks, std::vector<std::vector<uint32_t>> &out) {
+    if (g == rules.groups) {
+        if (blocks.size() <= MAX_STAGES) out.push_back(blocks);
+        return;
+    }
+    for (uint32_t &b : blocks) {
+        if (rules.conflicts[g] & b) continue;
+        b |= 1u << g;
+        partitions(rules, g + 1, blocks, out);
+        b &= ~(1u << g);
+    }
+    blocks.push_back(1u << g);
+    partitions(rules, g + 1, blocks, out);
+    blocks.pop_back();
+}
+
+static PlanSpec make_spec(const Options &o, int groups, const std::vector<uint32_t> &stages, const int *greens) {
+    PlanSpec spec;
+    spec.name = o.name;
+    spec.groups = groups;
+    spec.yellow_ms = uint32_t(o.yellow) * 1000;
+    spec.red_yellow_ms = uint32_t(o.red_yellow) * 1000;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        uint32_t ms = uint32_t(greens ? greens[i] : o.min_green) * 1000;
+        spec.stages.push_back({stages[i], ms, ms, -1});
+    }
+    return spec;
+}
+
+// Bölüntülerin ilk aşaması 1. grubu içeren aşamadır (çevrimin dönmesi aynı planı verir), kalan
+// aşamaların bütün dizilişleri denenir. En kısa yeşillerle ara süre kuralını bozan sıralar atılır.
+static std::vector<Structure> structures(const Options &o, const ConflictRules &rules) {
+    std::vector<std::vector<uint32_t>> parts;
+    std::vector<uint32_t> blocks;
+    partitions(rules, 0, blocks, parts);
+    std::vector<Structure> out;
+    for (std::vector<uint32_t> &p : parts) {
+        std::sort(p.begin() + 1, p.end());
+        do {
+            std::string error;
+            SignalPlan plan = compile_plan(make_spec(o, rules.groups, p, nullptr));
+            if (check_plan_conflicts(plan, rules, error)) out.push_back({p});
+        } while (std::next_permutation(p.begin() + 1, p.end()));
+    }
+    return out;
+}
+
+static int lost_time(const Options &o, size_t stages) { return stages > 1 ? int(stages) * (o.yellow + o.red_yellow) : 0; }
+
+// Aşamaların yeşil pencereleri: çevrim 0. sn'de ilk aşamanın yeşiliyle başlar.
+static void set_windows(const Options &o, const Structure &s, const int *greens, FlowBatch &b, int lane) {
+    int t = 0;
+    for (size_t i = 0; i < s.stages.size(); ++i) {
+        for (int g = 0; g < FlowDemand::MAX; ++g) {
+            if (!((s.stages[i] >> g) & 1)) continue;
+            b.start[g][lane] = t;
+            b.end[g][lane] = t + greens[i];
+        }
+        t += greens[i] + (s.stages.size() > 1 ? o.yellow + o.red_yellow : 0);
+    }
+}
+
+static void flush(const Options &o, const FlowDemand &d, WorkerState &w, int structure) {
+    if (!w.filled) return;
+    for (int l = w.filled; l < FlowBatch::LANES; ++l) {     // boş kulvarlar: hiç yeşil yok, sonucu okunmaz
+        for (int g = 0; g < d.groups; ++g) w.batch.start[g][l] = w.batch.end[g][l] = 0;
+    }
+    simulate_flow(d, w.batch, o.horizon);
+    for (int l = 0; l < w.filled; ++l) {
+        if (flow_saturation(d, w.batch, l) > o.max_saturation) continue;
+        float cost = flow_cost(d, w.batch, l);
+        if (cost < w.best.cost) {
+            w.best.cost = cost;
+            w.best.structure = structure;
+            w.best.cycle = w.batch.cycle;
+            std::copy(w.greens[l], w.greens[l] + MAX_STAGES, w.best.greens);
+        }
+    }
+    w.evaluated += w.filled;
+    w.filled = 0;
+}
+
+// greens[0..i) belirlenmiştir; kalan left saniye kalan aşamalara dağıtılır. Son aşama kalanı alır.
+static void enumerate(const Options &o, const FlowDemand &d, const Structure &s, int structure, WorkerState &w, int *greens, size_t i,
+                      int left) {
+    size_t k = s.stages.size();
+    if (i + 1 == k) {
+        if (left < o.min_green || left > o.max_green) return;
+        greens[i] = left;
+        std::copy(greens, greens + k, w.greens[w.filled]);
+        set_windows(o, s, greens, w.batch, w.filled);
+        if (++w.filled == FlowBatch::LANES) flush(o, d, w, structure);
+        return;
+    }
+    int rest = int(k - i - 1);
+    for (int g = o.min_green; g <= o.max_green && left - g >= rest * o.min_green; g += o.split_step) {
+        if (left - g > rest * o.max_green) continue;
+        greens[i] = g;
+        enumerate(o, d, s, structure, w, greens, i + 1, left - g);
+    }
+}
+
+static void print_plan(FILE *f, const Options &o, const FlowDemand &d, const ConflictRules &rules, const Structure &s, const Best &best,
+                       const FlowBatch &b) {
+    std::fprintf(f, "# plan_optimizer: talep");
+    for (size_t i = 0; i < o.rates.size(); ++i) std::fprintf(f, "%s%.0f", i ? "," : " ", o.rates[i]);
+    std::fprintf(f, " araç/saat, çevrim %d sn, ortalama gecikme %.1f sn/araç\n", best.cycle, best.cost);
+    for (int g = 0; g < d.groups; ++g) {
+        float arrived = d.arrival[g] * b.seconds;
+        std::fprintf(f, "#   t%d: gecikme %.1f sn/araç, geçen %.0f araç/saat, kuyruk artışı %.1f araç\n", g + 1,
+                     arrived > 0 ? (b.delay[g][0] + b.growth[g][0] * best.cycle) / arrived : 0.0f, b.served[g][0] * 3600.0f / b.seconds,
+                     b.growth[g][0]);
+    }
+    for (const uint32_t stage : s.stages) {
+        if (__builtin_popcount(stage) < 2) continue;
+        std::fprintf(f, "compatible ");
+        for (int g = 0, n = 0; g < d.groups; ++g) {
+            if ((stage >> g) & 1) std::fprintf(f, "%s%d", n++ ? "," : "", g + 1);
+        }
+        std::fprintf(f, "\n");
+    }
+    for (int i = 0; i < rules.groups; ++i) {
+        for (int j = 0; j < rules.groups; ++j) {
+            if (i != j && rules.intergreen_ms[i][j] != 3000) std::fprintf(f, "intergreen %d %d %g\n", i + 1, j + 1, rules.intergreen_ms[i][j] / 1000.0);
+        }
+    }
+    std::fprintf(f, "\nplan %s\ngroups %d\nyellow %d\nredyellow %d\n", o.name.c_str(), d.groups, o.yellow, o.red_yellow);
+    for (size_t i = 0; i < s.stages.size(); ++i) {
+        std::fprintf(f, "stage ");
+        for (int g = 0, n = 0; g < d.groups; ++g) {
+            if ((s.stages[i] >> g) & 1) std::fprintf(f, "%s%d", n++ ? "," : "", g + 1);
+        }
+        std::fprintf(f, " %d\n", best.greens[i]);
+    }
+    std::fprintf(f, "end\n");
+}
+
+static void usage(const char *argv0) {
+    std::fprintf(stderr,
+                 "Kullanım: %s --rates V1,V2,... [--saturation S[,S2,...]] [--rules FILE] [--cycle MIN-MAX] [--cycle-step N]"
+                 " [--min-green S] [--max-green S] [--split-step S] [--yellow S] [--redyellow S] [--max-saturation X]"
+                 " [--horizon S] [--threads N]"
+                 " [--name OPT] [--out FILE]\n",
+                 argv0);
+}
+
+int main(int argc, char **argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&] { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *arg = argv[i], *v = nullptr;
+        bool ok = true;
+        if (std::strcmp(arg, "--rates") == 0 && (v = next())) ok = parse_list(v, o.rates);
+        else if (std::strcmp(arg, "--saturation") == 0 && (v = next())) ok = parse_list(v, o.saturation);
+        else if (std::strcmp(arg, "--rules") == 0 && (v = next())) o.rules_file = v;
+        else if (std::strcmp(arg, "--out") == 0 && (v = next())) o.out_file = v;
+        else if (std::strcmp(arg, "--name") == 0 && (v = next())) o.name = v;
+        else if (std::strcmp(arg, "--cycle") == 0 && (v = next())) ok = std::sscanf(v, "%d-%d", &o.cycle_min, &o.cycle_max) == 2;
+        else if (std::strcmp(arg, "--cycle-step") == 0 && (v = next())) o.cycle_step = std::max(1, std::atoi(v));
+        else if (std::strcmp(arg, "--min-green") == 0 && (v = next())) o.min_green = std::max(1, std::atoi(v));
+        else if (std::strcmp(arg, "--max-green") == 0 && (v = next())) o.max_green = std::atoi(v);
+        else if (std::strcmp(arg, "--split-step") == 0 && (v = next())) o.split_step = std::max(1, std::atoi(v));
+        else if (std::strcmp(arg, "--yellow") == 0 && (v = next())) o.yellow = std::max(1, std::atoi(v));
+        else if (std::strcmp(arg, "--redyellow") == 0 && (v = next())) o.red_yellow = std::max(1, std::atoi(v));
+        else if (std::strcmp(arg, "--max-saturation") == 0 && (v = next())) o.max_saturation = float(std::atof(v));
+        else if (std::strcmp(arg, "--horizon") == 0 && (v = next())) o.horizon = std::max(1, std::atoi(v));
+        else if (std::strcmp(arg, "--threads") == 0 && (v = next())) o.threads = std::max(1, std::atoi(v));
+        else ok = false;
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    int groups = (int)o.rates.size();
+    if (groups < 1 || groups > FlowDemand::MAX || (o.saturation.size() != 1 && (int)o.saturation.size() != groups) ||
+        o.cycle_min < 1 || o.cycle_max < o.cycle_min || o.cycle_max > 65535 || o.max_green < o.min_green) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ConflictRules rules(groups, 3000);
+    if (o.rules_file) {
+        std::vector<SignalPlan> ignored;
+        std::string error;
+        if (!load_plan_file(o.rules_file, ignored, error, &rules)) {
+            std::fprintf(stderr, "Kural dosyası hatalı: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    FlowDemand demand;
+    demand.groups = groups;
+    for (int g = 0; g < groups; ++g) {
+        demand.arrival[g] = float(o.rates[g] / 3600.0);
+        demand.saturation[g] = float((o.saturation.size() == 1 ? o.saturation[0] : o.saturation[g]) / 3600.0);
+    }
+
+    std::vector<Structure> found = structures(o, rules);
+    std::vector<Task> tasks;
+    for (uint32_t s = 0; s < found.size(); ++s) {
+        int k = (int)found[s].stages.size();
+        for (int c = o.cycle_min; c <= o.cycle_max; c += o.cycle_step) {
+            int green = c - lost_time(o, k);
+            if (k == 1) {
+                if (green >= o.min_green && green <= o.max_green) tasks.push_back({s, uint16_t(c), uint16_t(green)});
+                continue;
+            }
+            for (int g1 = o.min_green; g1 <= o.max_green; g1 += o.split_step) {
+                int left = green - g1;
+                if (left >= (k - 1) * o.min_green && left <= (k - 1) * o.max_green) tasks.push_back({s, uint16_t(c), uint16_t(g1)});
+            }
+        }
+    }
+    if (tasks.empty()) {
+        std::fprintf(stderr, "Kurallara ve sürelere uyan aday yok\n");
+        return 1;
+    }
+
+    WorkStealingPool<Task> pool(o.threads);
+    std::vector<WorkerState> workers(pool.size());
+    auto t0 = std::chrono::steady_clock::now();
+    pool.run(tasks, [&](const Task &t, unsigned id) {
+        WorkerState &w = workers[id];
+        const Structure &s = found[t.structure];
+        int greens[MAX_STAGES] = {t.first_green};
+        w.batch.cycle = t.cycle;
+        int green = t.cycle - lost_time(o, s.stages.size());
+        if (s.stages.size() == 1) enumerate(o, demand, s, t.structure, w, greens, 0, green);
+        else enumerate(o, demand, s, t.structure, w, greens, 1, green - t.first_green);
+        flush(o, demand, w, t.structure);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    Best best;
+    unsigned long evaluated = 0;
+    for (const WorkerState &w : workers) {
+        evaluated += w.evaluated;
+        if (w.best.cost < best.cost) best = w.best;
+    }
+    std::fprintf(stderr, "threads,structures,tasks,candidates,seconds,candidates_per_min,steals,best_cost_s\n");
+    std::fprintf(stderr, "%u,%zu,%zu,%lu,%.3f,%.0f,%lu,%.2f\n", pool.size(), found.size(), tasks.size(), evaluated, seconds,
+                 evaluated / seconds * 60, pool.steals(), best.cost);
+    if (best.structure < 0) {
+        std::fprintf(stderr, "Doygunluk derecesi %.2f altında kalan plan yok; talep kavşağın kapasitesini aşıyor\n", o.max_saturation);
+        return 1;
+    }
+
+    // Seçilen plan tek kulvarda yeniden benzetilir (yaklaşım başına sonuçlar) ve kontrolcünün
+    // denetimlerinden geçirilir.
+    const Structure &s = found[best.structure];
+    WorkerState &w = workers[0];
+    w.batch.cycle = best.cycle;
+    for (int l = 0; l < FlowBatch::LANES; ++l) set_windows(o, s, best.greens, w.batch, l);
+    simulate_flow(demand, w.batch, o.horizon);
+    std::string error;
+    PlanSpec spec = make_spec(o, groups, s.stages, best.greens);
+    if (!validate_plan(spec, error) || !check_plan_conflicts(compile_plan(spec), rules, error)) {
+        std::fprintf(stderr, "Seçilen plan denetimden geçmedi: %s\n", error.c_str());
+        return 1;
+    }
+    FILE *f = o.out_file ? std::fopen(o.out_file, "w") : stdout;
+    if (!f) {
+        std::fprintf(stderr, "%s: açılamadı\n", o.out_file);
+        return 1;
+    }
+    print_plan(f, o, demand, rules, s, best, w.batch);
+    if (f != stdout) std::fclose(f);
+    if (o.out_file) {
+        std::vector<SignalPlan> loaded;
+        ConflictRules check(groups, 3000);
+        if (!load_plan_file(o.out_file, loaded, error, &check)) {
+            std::fprintf(stderr, "Yazılan plan yüklenemedi: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "clock.h"
+#include "signal_plan.h"
+
+class PlanVersionPool;
+
+// Yayımlanmış, değişmez plan sürümü. Yürütücü bir sürümü çalıştırırken ona kimse yazmaz; sıra
+// değişikliği yeni bir sürüm üretir.
+struct PlanVersion {
+    SignalPlan plan;
+    uint64_t version = 0;
+    Clock::time_point published{};
+    PlanVersionPool *pool = nullptr;    // sürümün döneceği havuz; havuz doluyken ayrılanlarda nullptr
+};
+
+// Sürümler başta kurulan sabit yuvalardan alınır; sıra değişikliği ve mod değişimi bellek ayırmaz.
+// Aynı anda en çok dört sürüm yaşar (çalışan, bekleyen, yayımlanmış, bırakılmış) ve yenisi eskisi
+// bırakılmadan kurulur; SLOTS bunu karşılar. Yuvalar atomik işaretlerle alınıp bırakılır, yazıcı ve
+// okuyucu ayrı iş parçacıklarında olabilir. Yine de yuva kalmazsa sürüm heap'ten ayrılır (heap_guard
+// bunu sayar).
+class PlanVersionPool {
+public:
+    static constexpr int SLOTS = 8;
+
+    PlanVersion *acquire(const SignalPlan &plan, uint64_t version, Clock::time_point published) {
+        for (int i = 0; i < SLOTS; ++i) {
+            if (used[i].load(std::memory_order_relaxed) || used[i].exchange(true, std::memory_order_acquire)) continue;
+            slots[i].plan = plan;
+            slots[i].version = version;
+            slots[i].published = published;
+            slots[i].pool = this;
+            return &slots[i];
+        }
+        ++overflows;
+        return new PlanVersion{plan, version, published, nullptr};
+    }
+
+    static void release(PlanVersion *v) {
+        if (!v) return;
+        if (!v->pool) {
+            delete v;
+            return;
+        }
+        v->pool->used[v - v->pool->slots].store(false, std::memory_order_release);
+    }
+
+    std::atomic<unsigned long> overflows{0};
+
+private:
+    PlanVersion slots[SLOTS];
+    std::atomic<bool> used[SLOTS] = {};
+};
+
+// std::unique_ptr için: sürüm havuzuna döner.
+struct PlanVersionRelease {
+    void operator()(PlanVersion *v) const { PlanVersionPool::release(v); }
+};
+using PlanVersionPtr = std::unique_ptr<PlanVersion, PlanVersionRelease>;
+
+// RCU benzeri sürüm değişimi: yazıcı (komut işleyici) yeni sürümü atomik pending işaretçisine koyar,
+// okuyucu (plan yürütücüsü) onu güvenli sınırda tek bir exchange ile alır. Bıraktığı eski sürümü
+// retired'a koyar; havuza geri verme işi yazıcıya kalır. Tek yazıcı ve tek okuyucu içindir. Alınmadan
+// üzerine yeni sürüm yazılan sürüm hemen havuza döner.
+class PlanSwap {
+public:
+    ~PlanSwap() {
+        PlanVersionPool::release(pending.load(std::memory_order_acquire));
+        PlanVersionPool::release(retired.load(std::memory_order_acquire));
+    }
+
+    // Yazıcı.
+    void publish(PlanVersion *v) {
+        reclaim();
+        PlanVersionPool::release(pending.exchange(v, std::memory_order_acq_rel));
+        reclaim();
+    }
+
+    // Yazıcı: okuyucunun bıraktığı sürüm havuza döner.
+    void reclaim() { PlanVersionPool::release(retired.exchange(nullptr, std::memory_order_acq_rel)); }
+
+    // Okuyucu: bekleyen sürüm varsa sahipliği alınır.
+    PlanVersion *take() {
+        if (!pending.load(std::memory_order_relaxed)) return nullptr;
+        return pending.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    // Okuyucu: artık kullanılmayan sürüm yazıcıya bırakılır. Yazıcı araya bir yayın sokmadan iki kez
+    // bırakılırsa öncekini okuyucu havuza verir; bu ancak yayınlar güvenli sınırlardan sık gelirse olur.
+    void retire(PlanVersion *v) { PlanVersionPool::release(retired.exchange(v, std::memory_order_acq_rel)); }
+
+    bool has_pending() const { return pending.load(std::memory_order_acquire) != nullptr; }
+
+private:
+    std::atomic<PlanVersion *> pending{nullptr};
+    std::atomic<PlanVersion *> retired{nullptr};
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+// Protokol izi. Kontrolcüye gelen her komut, yanıtı, geliş anı, işlenme süresi ve kaynağıyla
+// (standart giriş, seri hat, soket istemcisi) sırayla bir dosyaya eklenir. Sahadaki bir sorun izle
+// yeniden üretilir; trace_replay izi aynı zamanlamayla ya da hızlandırılmış olarak bir kontrolcüye
+// yeniden oynatır. Kayıtlar bellekteki bir tampona yazılır, tampon dolunca ya da flush() ile
+// (saniyede bir) tek write ile dosyaya eklenir; komut yolunda sistem çağrısı yapılmaz.
+//
+// Dosya biçimi: TraceFileHeader, ardından kayıtlar. Her kayıt bir TraceRecord ve hemen arkasından
+// command_len bayt komut ve reply_len bayt yanıttır (sonlandırıcı yoktur).
+
+enum TraceSource : uint16_t {
+    TRACE_SOURCE_STDIN = 0,
+    TRACE_SOURCE_SERIAL = 1,
+    // 2'den büyük değerler soket istemcisinin fd'sidir; aynı anda bağlı istemciler ayrılır
+};
+
+struct TraceFileHeader {
+    char magic[8];                  // "JCTRACE1"
+    uint32_t version;
+    uint32_t record_size;           // sizeof(TraceRecord)
+    uint64_t start_realtime_ns;     // izin başladığı an, CLOCK_REALTIME
+    uint64_t reserved;
+};
+static_assert(sizeof(TraceFileHeader) == 32, "başlık boyutu dosya biçiminin parçasıdır");
+
+struct TraceRecord {
+    uint64_t time_ns;       // komutun geliş anı, izin başından beri (CLOCK_MONOTONIC)
+    uint32_t service_ns;    // komutun işlenme süresi
+    uint16_t source;        // TraceSource ya da soket fd'si
+    uint16_t command_len;
+    uint16_t reply_len;
+    uint16_t reserved[3];
+};
+static_assert(sizeof(TraceRecord) == 24, "kayıt boyutu dosya biçiminin parçasıdır");
+
+constexpr char TRACE_MAGIC[8] = {'J', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+
+class ProtocolTraceWriter {
+public:
+    static constexpr size_t BUFFER = 64 * 1024;
+
+    ~ProtocolTraceWriter() { close(); }
+
+    // Var olan dosyanın üzerine yazılır.
+    bool open(const char *path) {
+        fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        start = std::chrono::steady_clock::now();
+        TraceFileHeader h{};
+        std::memcpy(h.magic, TRACE_MAGIC, 8);
+        h.version = 1;
+        h.record_size = sizeof(TraceRecord);
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        h.start_realtime_ns = uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        append(&h, sizeof(h));
+        return flush();
+    }
+
+    bool is_open() const { return fd >= 0; }
+
+    void record(uint16_t source, std::chrono::steady_clock::time_point at, std::chrono::nanoseconds service, std::string_view command,
+                std::string_view reply) {
+        if (fd < 0) return;
+        TraceRecord r{};
+        r.time_ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(at - start).count());
+        r.service_ns = uint32_t(std::min<int64_t>(service.count(), UINT32_MAX));
+        r.source = source;
+        r.command_len = uint16_t(std::min<size_t>(command.size(), UINT16_MAX));
+        r.reply_len = uint16_t(std::min<size_t>(reply.size(), UINT16_MAX));
+        size_t size = sizeof(r) + r.command_len + r.reply_len;
+        if (len + size > BUFFER && !flush()) return;
+        if (size > BUFFER) {        // tampona sığmayan kayıt (olmamalı: komut ve yanıt 4 KB ile sınırlı)
+            ++dropped;
+            return;
+        }
+        append(&r, sizeof(r));
+        append(command.data(), r.command_len);
+        append(reply.data(), r.reply_len);
+        ++records;
+    }
+
+    // Tampondakileri dosyaya ekler. Yazma hatasında iz kapatılır ve kontrolcü çalışmaya devam eder.
+    bool flush() {
+        size_t off = 0;
+        while (fd >= 0 && off < len) {
+            ssize_t n = ::write(fd, buf + off, len - off);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                ::close(fd);
+                fd = -1;
+                ++write_errors;
+                break;
+            }
+            off += n;
+        }
+        len = 0;
+        return fd >= 0;
+    }
+
+    void close() {
+        if (fd < 0) return;
+        flush();
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    unsigned long records = 0;
+    unsigned long dropped = 0;
+    unsigned long write_errors = 0;
+
+private:
+    void append(const void *p, size_t n) {
+        std::memcpy(buf + len, p, n);
+        len += n;
+    }
+
+    int fd = -1;
+    std::chrono::steady_clock::time_point start;
+    char buf[BUFFER];
+    size_t len = 0;
+};
+
+// İzdeki bir kayıt; command ve reply okuyucunun tamponunu gösterir.
+struct TraceEntry {
+    TraceRecord rec;
+    std::string_view command;
+    std::string_view reply;
+};
+
+// İz dosyasını bütünüyle belleğe okur. Kontrolcü kapanmadan kesilmiş bir izin son yarım kaydı atılır.
+class ProtocolTraceReader {
+public:
+    bool open(const char *path, std::string &error) {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return error = std::string(path) + ": " + std::strerror(errno), false;
+        char chunk[65536];
+        ssize_t n;
+        while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) data.append(chunk, n);
+        ::close(fd);
+        if (data.size() < sizeof(TraceFileHeader)) return error = "iz dosyası değil", false;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, TRACE_MAGIC, 8) != 0 || header.record_size != sizeof(TraceRecord))
+            return error = "iz dosyası değil ya da sürümü farklı", false;
+        pos = sizeof(TraceFileHeader);
+        return true;
+    }
+
+    bool next(TraceEntry &e) {
+        if (data.size() - pos < sizeof(TraceRecord)) return false;
+        std::memcpy(&e.rec, data.data() + pos, sizeof(TraceRecord));
+        size_t body = size_t(e.rec.command_len) + e.rec.reply_len;
+        if (data.size() - pos - sizeof(TraceRecord) < body) return false;
+        const char *p = data.data() + pos + sizeof(TraceRecord);
+        e.command = std::string_view(p, e.rec.command_len);
+        e.reply = std::string_view(p + e.rec.command_len, e.rec.reply_len);
+        pos += sizeof(TraceRecord) + body;
+        return true;
+    }
+
+    TraceFileHeader header{};
+
+private:
+    std::string data;
+    size_t pos = 0;
+};
@@ -0,0 +1,193 @@
+// Zamanlama iş parçacığının uyanma gecikmesi (cyclictest benzeri). Gerçek ModeRunner, sahte GPIO arka
+// ucu ve monoton saatle TimingThread üzerinde --interval-ms uzunluğunda adımlardan oluşan bir plan
+// yürütülür; her adımda planlanan bitiş ile zamanlayıcının gerçekten uyandığı an arasındaki fark
+// (step_late) ölçülür. Ölçüm sırasında ayrı süreçler yük bindirir: --cpu-stress kadar boş döngü ve
+// --io-stress kadar write/fsync/read döngüsü (--io-dir altında silinmiş geçici dosyalara). Önce
+// normal zamanlayıcıyla, sonra SCHED_FIFO, sabit çekirdek ve kilitli bellekle ölçülür; sonuçlar CSV
+// olarak verilir. Yetki yoksa gerçek zamanlı ölçüm uyarıyla normal öncelikte yapılır. --budget-us
+// verilirse gerçek zamanlı ölçümün en kötü gecikmesi bunu aştığında çıkış kodu 2'dir.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target rt_latency
+// Kullanım: sudo rt_latency [--mode rt|normal|both] [--seconds 60] [--interval-ms 5] [--cpu N] [--priority 80]
+//                          [--cpu-stress N] [--io-stress 2] [--io-dir /tmp] [--budget-us 200] > gecikme.csv
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "event_loop.h"
+#include "gpio_output.h"
+#include "mode_runner.h"
+#include "pin_map.h"
+#include "rt_thread.h"
+#include "timing_thread.h"
+
+struct RunResult {
+    const char *run;
+    int policy, priority, cpu;
+    LatencyHistogram lateness;
+};
+
+static void cpu_stress() {
+    volatile unsigned long n = 0;
+    for (;;) n = n + 1;
+}
+
+static void io_stress(const char *dir) {
+    std::string path = std::string(dir) + "/rt_latency.XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) _exit(1);
+    unlink(path.c_str());
+    static char block[1 << 20];
+    std::memset(block, 0x5a, sizeof(block));
+    for (;;) {
+        for (int i = 0; i < 16; ++i) {
+            if (write(fd, block, sizeof(block)) < 0) _exit(1);
+        }
+        fsync(fd);
+        lseek(fd, 0, SEEK_SET);
+        while (read(fd, block, sizeof(block)) > 0) {}
+        if (ftruncate(fd, 0) != 0) _exit(1);
+        lseek(fd, 0, SEEK_SET);
+    }
+}
+
+// Yük süreçleri ölçümden önce başlar, sonra SIGKILL ile durdurulur.
+static std::vector<pid_t> start_stress(int cpu, int io, const char *dir) {
+    std::vector<pid_t> pids;
+    for (int i = 0; i < cpu + io; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (i < cpu) cpu_stress();
+            io_stress(dir);
+        }
+        if (pid > 0) pids.push_back(pid);
+    }
+    return pids;
+}
+
+static void stop_stress(const std::vector<pid_t> &pids) {
+    for (pid_t pid : pids) kill(pid, SIGKILL);
+    for (pid_t pid : pids) waitpid(pid, nullptr, 0);
+}
+
+static bool measure(const char *run, RtConfig cfg, int seconds, int interval_ms, RunResult &result) {
+    TimingThread timing;
+    SteadyClock clock;
+    MockBackend backend;
+    JunctionOutput out(backend, default_pins());
+    out.init(0);
+    Timer timer(timing.loop);
+    ModeRunner runner(out, clock, timer, HEAD_COUNT);
+    SignalPlan plan = runner.sequencePlan;      // gerçek çıkış maskeleri, sabit kısa adımlar
+    plan.name = "LATENCY";
+    for (size_t i = 0; i < plan.steps.size(); ++i) {
+        plan.steps[i].min_ms = plan.steps[i].max_ms = uint32_t(interval_ms);
+        plan.steps[i].detector = -1;
+    }
+    runner.customPlan = &plan;
+    runner.start(Mode::PLAN);
+
+    std::string error;
+    if (!timing.start(cfg, error)) {
+        if (!cfg.realtime) {
+            std::fprintf(stderr, "%s: %s\n", run, error.c_str());
+            return false;
+        }
+        std::fprintf(stderr, "Uyarı: %s; gerçek zamanlı ölçüm normal öncelikte yapılıyor\n", error.c_str());
+        cfg.realtime = false;
+        if (!timing.start(cfg, error)) {
+            std::fprintf(stderr, "%s: %s\n", run, error.c_str());
+            return false;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    timing.call([&] { runner.set_heads(0, CAUSE_SHUTDOWN); });
+    timing.stop();
+    result.run = run;
+    result.policy = timing.rt().policy;
+    result.priority = timing.rt().priority;
+    result.cpu = timing.rt().cpu;
+    result.lateness = runner.step_lateness;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *mode = "both";
+    int seconds = 60;
+    int interval_ms = 5;
+    int cpu = rt_last_cpu();
+    int priority = 80;
+    long nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    int cpu_load = nproc > 0 ? int(nproc) : 1;
+    int io_load = 2;
+    const char *io_dir = "/tmp";
+    double budget_us = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--mode") == 0 && i + 1 < argc) mode = argv[++i];
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) interval_ms = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) cpu = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--priority") == 0 && i + 1 < argc) priority = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--cpu-stress") == 0 && i + 1 < argc) cpu_load = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--io-stress") == 0 && i + 1 < argc) io_load = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--io-dir") == 0 && i + 1 < argc) io_dir = argv[++i];
+        else if (std::strcmp(argv[i], "--budget-us") == 0 && i + 1 < argc) budget_us = std::atof(argv[++i]);
+        else {
+            std::fprintf(stderr, "Kullanım: %s [--mode rt|normal|both] [--seconds 60] [--interval-ms 5] [--cpu N] [--priority 80]"
+                                 " [--cpu-stress N] [--io-stress 2] [--io-dir /tmp] [--budget-us 200]\n", argv[0]);
+            return 1;
+        }
+    }
+    const bool run_normal = std::strcmp(mode, "normal") == 0 || std::strcmp(mode, "both") == 0;
+    const bool run_rt = std::strcmp(mode, "rt") == 0 || std::strcmp(mode, "both") == 0;
+    if (seconds <= 0 || interval_ms <= 0 || (!run_normal && !run_rt)) {
+        std::fprintf(stderr, "Geçersiz ölçüm ayarı\n");
+        return 1;
+    }
+
+    std::vector<pid_t> stress = start_stress(cpu_load, io_load, io_dir);
+    std::vector<RunResult> results;
+    bool ok = true;
+    if (run_normal) {       // eski kurulum: normal zamanlayıcı, sabitleme ve bellek kilidi yok
+        RtConfig cfg;
+        cfg.realtime = false;
+        results.emplace_back();
+        ok = measure("normal", cfg, seconds, interval_ms, results.back());
+    }
+    if (ok && run_rt) {     // bellek kilidi geri alınmaz; normal ölçümden sonra yapılır
+        std::string error;
+        if (!rt_lock_memory(error)) std::fprintf(stderr, "Uyarı: %s\n", error.c_str());
+        RtConfig cfg;
+        cfg.cpu = cpu;
+        cfg.priority = priority;
+        results.emplace_back();
+        ok = measure("rt", cfg, seconds, interval_ms, results.back());
+    }
+    stop_stress(stress);
+    if (!ok) return 1;
+
+    auto us = [](double ns) { return ns / 1000.0; };
+    std::printf("run,policy,priority,cpu,cpu_stress,io_stress,interval_ms,samples,min_us,p50_us,p99_us,p999_us,max_us,mean_us\n");
+    int status = 0;
+    for (const RunResult &r : results) {
+        const LatencyHistogram &h = r.lateness;
+        std::printf("%s,%s,%d,%d,%d,%d,%d,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", r.run, rt_policy_name(r.policy), r.priority,
+                    r.cpu, cpu_load, io_load, interval_ms, (unsigned long long)h.count(), us(h.min()), us(h.percentile(50)),
+                    us(h.percentile(99)), us(h.percentile(99.9)), us(h.max()), us(h.mean()));
+        if (budget_us > 0 && std::strcmp(r.run, "rt") == 0 && us(h.max()) > budget_us) {
+            std::fprintf(stderr, "En kötü gecikme %.1f us, bütçe %.1f us\n", us(h.max()), budget_us);
+            status = 2;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Gerçek zamanlı iş parçacığı. Zamanlama yolu (plan adımları, GPIO yazması) ayrı bir çekirdeğe
+// sabitlenmiş, SCHED_FIFO öncelikli bir iş parçacığında çalışır; normal öncelikteki işler (komut
+// girişi, soketler, günlük, SSH) onu kesemez. Bellek mlockall ile kilitlenir ve iş parçacığının yığını
+// başta dokunularak sayfalara ayrılır: zamanlama yolunda sayfa hatası olmaz.
+
+struct RtConfig {
+    bool realtime = true;           // false: normal zamanlayıcı (karşılaştırma ölçümleri için)
+    int priority = 80;              // SCHED_FIFO 1-99
+    int cpu = -1;                   // sabitlenecek çekirdek, -1: sabitleme yok
+    size_t stack_size = 256 * 1024;
+    size_t prefault = 128 * 1024;   // başta dokunulan yığın, stack_size'dan küçük olmalı
+};
+
+// Sürecin bütün belleğini (şimdiki ve sonradan eşlenecek) kilitler. Serbest bırakılan heap sisteme
+// geri verilmez ve büyük ayırmalar ayrı mmap ile yapılmaz; sonradan yeniden sayfa hatası olmaz.
+inline bool rt_lock_memory(std::string &error) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        error = std::string("mlockall: ") + std::strerror(errno) + " (CAP_IPC_LOCK ya da RLIMIT_MEMLOCK gerekir)";
+        return false;
+    }
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    return true;
+}
+
+inline int rt_last_cpu() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? int(n - 1) : 0;
+}
+
+// Yığının ilk bytes baytına dokunur; mlockall ile birlikte sayfalar kalıcı olarak ayrılır.
+__attribute__((noinline)) inline void rt_prefault_stack(size_t bytes) {
+    volatile char *p = static_cast<volatile char *>(alloca(bytes));
+    for (size_t i = 0; i < bytes; i += 4096) p[i] = 0;
+}
+
+inline const char *rt_policy_name(int policy) {
+    switch (policy) {
+        case SCHED_FIFO: return "SCHED_FIFO";
+        case SCHED_RR: return "SCHED_RR";
+        default: return "SCHED_OTHER";
+    }
+}
+
+class RtThread {
+public:
+    RtThread() = default;
+    RtThread(const RtThread &) = delete;
+    RtThread &operator=(const RtThread &) = delete;
+    ~RtThread() { join(); }
+
+    // İş parçacığını başlatır, ayarlar uygulanana kadar bekler. Ayar uygulanamazsa body çalışmaz,
+    // açıklama error'a yazılır ve false döner.
+    bool start(const RtConfig &config, std::function<void()> fn, std::string &error) {
+        cfg = config;
+        body = std::move(fn);
+        setup_done = false;
+        setup_error.clear();
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, cfg.stack_size);
+        if (cfg.realtime) {
+            sched_param param{};
+            param.sched_priority = cfg.priority;
+            pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+            pthread_attr_setschedparam(&attr, &param);
+        }
+        started = true;
+        int rc = pthread_create(&thread, &attr, &RtThread::entry, this);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            started = false;
+            error = rc == EPERM ? "SCHED_FIFO için yetki yok (CAP_SYS_NICE ya da RLIMIT_RTPRIO gerekir)"
+                                : std::string("pthread_create: ") + std::strerror(rc);
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return setup_done; });
+        if (!setup_error.empty()) {
+            error = setup_error;
+            join();
+            return false;
+        }
+        return true;
+    }
+
+    void join() {
+        if (!started) return;
+        pthread_join(thread, nullptr);
+        started = false;
+    }
+
+    bool running() const { return started; }
+    bool is_current() const { return started && pthread_equal(pthread_self(), self); }
+
+    // İş parçacığının gerçekte aldığı ayarlar.
+    int policy = SCHED_OTHER;
+    int priority = 0;
+    int cpu = -1;
+
+private:
+    static void *entry(void *self) {
+        static_cast<RtThread *>(self)->main();
+        return nullptr;
+    }
+
+    void main() {
+        self = pthread_self();      // başlatan taraf ayarları beklerken görür
+        std::string why;
+        if (cfg.cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cfg.cpu, &set);
+            int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (rc != 0) why = "çekirdek " + std::to_string(cfg.cpu) + " seçilemedi: " + std::strerror(rc);
+        }
+        if (why.empty()) {
+            rt_prefault_stack(cfg.prefault);
+            sched_param param{};
+            pthread_getschedparam(pthread_self(), &policy, &param);
+            priority = param.sched_priority;
+            cpu = cfg.cpu;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            setup_error = why;
+            setup_done = true;
+        }
+        ready.notify_one();
+        if (why.empty()) body();
+    }
+
+    RtConfig cfg;
+    std::function<void()> body;
+    pthread_t thread{};
+    pthread_t self{};
+    bool started = false;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool setup_done = false;
+    std::string setup_error;
+};
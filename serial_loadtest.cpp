@@ -0,0 +1,201 @@
+// Seri komut hattının sözde terminal (pty) üzerinde yük testi. Kontrolcü sahte GPIO arka ucuyla
+// aynı süreçte çalışır ve pty'nin uydu ucunu SerialTransport ile açar; test ana uçtan hat hızında
+// (ya da hız sınırı olmadan) komut yağdırır. Komutlar rastgele uzunlukta parçalara bölünerek yazılır,
+// böylece yarım ve birleşik çerçeveler oluşur. Her komut SETMINSEQTIMEOUT=n'dir ve yanıtındaki n
+// sırayla denetlenir: kayıp, bölünmüş ya da sırası bozulmuş yanıt sayılır. Yükten önce halka tampon,
+// halkanın sonundan başına sarılan ve ayırıcısı aynı okumada gelen çok uzun bir çerçeveyle denenir:
+// çerçeve tek bir "çok uzun" bildirimiyle atılmalı, ardından gelen komut bozulmadan verilmelidir.
+// Sonuçlar CSV olarak verilir; hata varsa çıkış kodu 1'dir.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target serial_loadtest
+// Kullanım: serial_loadtest [--baud N] [--commands N] [--burst N] [--chunk N]
+//           (--baud verilmezse 115200, 460800, 921600 ve sınırsız hız sırayla denenir; 0: sınırsız)
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "controller.h"
+#include "event_loop.h"
+#include "gpio_output.h"
+#include "mode_runner.h"
+#include "pin_map.h"
+#include "serial_transport.h"
+
+struct LoadResult {
+    long baud;
+    unsigned long commands, ok = 0, bad = 0, missing = 0;
+    unsigned long bytes_out = 0, bytes_in = 0, writes = 0, wrapped = 0;
+    double seconds = 0;
+};
+
+static const char REPLY_PREFIX[] = "Minumum zaman aşımı süresi güncellendi: ";
+
+// Baytları tek okuma gibi halkaya yazar ve çerçeveleri işler.
+template <typename F, typename G>
+static void feed(FrameRing &ring, const std::string &bytes, F &&on_frame, G &&on_overflow) {
+    iovec iov[2];
+    int parts = ring.space(iov);
+    size_t off = 0;
+    for (int i = 0; i < parts && off < bytes.size(); ++i) {
+        size_t n = std::min(iov[i].iov_len, bytes.size() - off);
+        std::memcpy(iov[i].iov_base, bytes.data() + off, n);
+        off += n;
+    }
+    ring.produced(off);
+    ring.frames(on_frame, on_overflow);
+}
+
+// Halkanın sonunu 3500 baytlık kısa komutlarla ilerletir, sonra sarılan 2000 baytlık bir satırı
+// ayırıcısı ve ardından gelen komutla birlikte tek okumada verir.
+static bool check_oversized_wrapped() {
+    FrameRing ring;
+    std::string frames, bad;
+    unsigned long overflows = 0;
+    auto on_frame = [&](std::string_view f) {
+        if (f.size() >= FrameRing::MAX_FRAME) bad = "çerçeve sınırı aşıldı";
+        frames.assign(f.data(), f.size());
+    };
+    auto on_overflow = [&] { ++overflows; };
+    std::string warmup;
+    while (warmup.size() + 8 <= 3500) warmup += "GETMODE\r";
+    feed(ring, warmup, on_frame, on_overflow);
+    feed(ring, std::string(2000, 'A') + "\rGETMODE\r", on_frame, on_overflow);
+    if (bad.empty() && overflows != 1) bad = "çok uzun bildirimi " + std::to_string(overflows) + " kez";
+    if (bad.empty() && frames != "GETMODE") bad = "uzun çerçeveden sonraki komut bozuk";
+    if (!bad.empty()) std::fprintf(stderr, "Sarılan uzun çerçeve: %s\n", bad.c_str());
+    return bad.empty();
+}
+
+static bool run_load(long baud, unsigned long commands, unsigned burst, unsigned chunk, LoadResult &r) {
+    r = {baud, commands};
+    int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) return false;
+    const char *slave = ptsname(master);
+
+    EventLoop loop;
+    SteadyClock clock;
+    Timer modeTimer(loop), timeoutTimer(loop);
+    MockBackend backend;
+    JunctionOutput out(backend, default_pins());
+    out.init(0);
+    ModeRunner runner(out, clock, modeTimer, HEAD_COUNT);
+    Controller controller(out, runner, clock, timeoutTimer);
+    controller.start();
+    SerialTransport serial(loop, controller);
+    std::string error;
+    if (!serial.open(slave, baud ? baud : 921600, false, error)) {
+        std::fprintf(stderr, "%s: %s\n", slave, error.c_str());
+        close(master);
+        return false;
+    }
+    serial.on_close = [&] { loop.stop(); };
+    std::thread controller_thread([&] { loop.run(); });
+
+    // Yanıtlar ayrı iş parçacığında okunur ve sırayla denetlenir.
+    std::thread receiver([&] {
+        std::string line;
+        unsigned long expect = 1;
+        char buf[4096];
+        pollfd p = {master, POLLIN, 0};
+        while (expect <= commands && poll(&p, 1, 2000) == 1) {     // 2 sn yanıt gelmezse kalanlar kayıptır
+            ssize_t n = read(master, buf, sizeof(buf));
+            if (n <= 0) break;
+            r.bytes_in += n;
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buf[i] != '\r') {
+                    line.push_back(buf[i]);
+                    continue;
+                }
+                char *end = nullptr;
+                unsigned long got = 0;
+                if (line.compare(0, sizeof(REPLY_PREFIX) - 1, REPLY_PREFIX) == 0)
+                    got = std::strtoul(line.c_str() + sizeof(REPLY_PREFIX) - 1, &end, 10);
+                if (got == expect && end && std::strcmp(end, " saniye") == 0) {
+                    ++r.ok;
+                } else {
+                    ++r.bad;
+                    if (got > expect) r.missing += got - expect;
+                }
+                if (got >= expect) expect = got + 1;
+                line.clear();
+            }
+        }
+    });
+
+    // Gönderim: burst komut bir arada, rastgele parçalarla; hat hızı baud / 10 bayt/sn ile sınırlanır.
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> piece(1, chunk);
+    std::string batch;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned long i = 1; i <= commands;) {
+        batch.clear();
+        for (unsigned b = 0; b < burst && i <= commands; ++b, ++i) batch += "SETMINSEQTIMEOUT=" + std::to_string(i) + "\r";
+        for (size_t off = 0; off < batch.size();) {
+            size_t n = std::min<size_t>(piece(rng), batch.size() - off);
+            ssize_t w = write(master, batch.data() + off, n);
+            if (w <= 0) break;
+            off += w;
+            r.bytes_out += w;
+            if (baud) std::this_thread::sleep_until(t0 + std::chrono::duration<double>(r.bytes_out * 10.0 / baud));
+        }
+    }
+    receiver.join();
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (r.ok + r.bad < commands) r.missing += commands - r.ok - r.bad - r.missing;
+    close(master);          // uydu uç EIO alır, döngü durur
+    controller_thread.join();
+    r.writes = serial.writes;
+    r.wrapped = serial.ring().wrapped;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    std::vector<long> bauds = {115200, 460800, 921600, 0};
+    unsigned long commands = 2000;
+    unsigned burst = 32, chunk = 48;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--baud") == 0 && i + 1 < argc) bauds = {std::atol(argv[++i])};
+        else if (std::strcmp(argv[i], "--commands") == 0 && i + 1 < argc) commands = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--burst") == 0 && i + 1 < argc) burst = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) chunk = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr, "Kullanım: %s [--baud N] [--commands N] [--burst N] [--chunk N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int status = check_oversized_wrapped() ? 0 : 1;
+    std::ostringstream silent;      // kontrolcü mesajları CSV'ye karışmasın
+    std::streambuf *saved_cout = std::cout.rdbuf(silent.rdbuf());
+    std::vector<LoadResult> results;
+    for (long baud : bauds) {
+        LoadResult r;
+        if (!run_load(baud, commands, burst, chunk, r)) {
+            std::cout.rdbuf(saved_cout);
+            std::fprintf(stderr, "pty açılamadı\n");
+            return 1;
+        }
+        results.push_back(r);
+    }
+    std::cout.rdbuf(saved_cout);
+
+    std::printf("baud,commands,seconds,commands_per_sec,bytes_out,bytes_in,line_util,replies_ok,bad,missing,writes,wrapped\n");
+    for (const LoadResult &r : results) {
+        double util = r.baud ? (r.bytes_out * 10.0 / r.baud) / r.seconds : 0;
+        std::printf("%ld,%lu,%.3f,%.0f,%lu,%lu,%.2f,%lu,%lu,%lu,%lu,%lu\n", r.baud, r.commands, r.seconds, r.ok / r.seconds, r.bytes_out,
+                    r.bytes_in, util, r.ok, r.bad, r.missing, r.writes, r.wrapped);
+        if (r.ok != r.commands) status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <fcntl.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "command_dispatch.h"
+#include "controller.h"
+#include "event_loop.h"
+
+// Seri hattan gelen baytlar için sabit boyutlu halka tampon ve '\r' çerçeveleme. Okuma readv ile
+// doğrudan halkanın boş kısımlarına yapılır. Tamamlanan çerçeveler halkanın içinden string_view
+// olarak verilir, kopyalanmaz. Yalnızca halkanın sonundan başına sarılan çerçeve küçük bir tampona
+// birleştirilir. Yarım kalan çerçeve sonraki okumayı bekler; tek okumada gelen çok sayıda çerçeve
+// sırayla verilir. '\n' de ayırıcı kabul edilir (terminal).
+class FrameRing {
+public:
+    static constexpr size_t SIZE = 4096;        // 2'nin kuvveti
+    static constexpr size_t MAX_FRAME = 1024;   // daha uzun çerçeveler atılır
+
+    // Boş alanı (en fazla iki parça) iov'a yazar; parça sayısını döndürür.
+    int space(iovec *iov) {
+        size_t free_bytes = SIZE - (tail - head);
+        if (!free_bytes) return 0;
+        size_t t = tail & (SIZE - 1);
+        size_t first = std::min(free_bytes, SIZE - t);
+        iov[0] = {buf + t, first};
+        if (first == free_bytes) return 1;
+        iov[1] = {buf, free_bytes - first};
+        return 2;
+    }
+
+    void produced(size_t n) { tail += n; }
+
+    // Tamamlanan her çerçeve için on_frame(frame), çok uzun çerçeve için bir kez on_overflow() çağrılır.
+    // Sınır tarama sırasında denetlenir; verilen çerçeveler MAX_FRAME'den kısadır (view() buna güvenir).
+    template <typename F, typename G>
+    void frames(F &&on_frame, G &&on_overflow) {
+        for (; scan != tail; ++scan) {
+            char c = buf[scan & (SIZE - 1)];
+            if (c != '\r' && c != '\n') {
+                if (scan + 1 - head >= MAX_FRAME) {     // çerçeve sınırı aştı; ayırıcıya kadar atılır
+                    if (!discarding) on_overflow();
+                    discarding = true;
+                    head = scan + 1;
+                }
+                continue;
+            }
+            if (!discarding && scan > head) on_frame(view(head, scan));
+            discarding = false;
+            head = scan + 1;
+        }
+    }
+
+    size_t pending() const { return tail - head; }
+    unsigned long wrapped = 0;      // birleştirilmek zorunda kalan çerçeveler
+
+private:
+    std::string_view view(size_t from, size_t to) {
+        size_t f = from & (SIZE - 1), n = to - from;
+        if (f + n <= SIZE) return std::string_view(buf + f, n);
+        size_t first = SIZE - f;
+        std::memcpy(joined, buf + f, first);
+        std::memcpy(joined + first, buf, n - first);
+        ++wrapped;
+        return std::string_view(joined, n);
+    }
+
+    char buf[SIZE];
+    char joined[MAX_FRAME];
+    size_t head = 0;        // ilk işlenmemiş bayt (sayaçlar taşana kadar artar, indeks & (SIZE - 1))
+    size_t tail = 0;        // yazılan son baytın bir sonrası
+    size_t scan = 0;        // ayırıcı aranmış son konum
+    bool discarding = false;
+};
+
+inline speed_t baud_constant(long baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        default: return B0;
+    }
+}
+
+// RS-232/RS-485 komut hattı. Port ham kipte (8N1, yankısız, satır düzenlemesiz) ve bloklamadan
+// açılır; okunabilen her şey halkaya alınır, bütün çerçeveler işlenir ve yanıtları tek write ile
+// gönderilir. Her yanıt '\r' ile biter. Hat yazmaya yetişemezse kalan yanıt EPOLLOUT ile gönderilir
+// ve bekleyen yanıt MAX_PENDING_OUT'u aşarsa okuma durdurulur; veri sürücünün tamponunda bekler.
+class SerialTransport {
+public:
+    static constexpr size_t MAX_PENDING_OUT = 16 * 1024;
+    static constexpr int MAX_READS_PER_EVENT = 8;
+
+    SerialTransport(EventLoop &loop, Controller &controller) : loop(loop), controller(controller) {}
+
+    ~SerialTransport() {
+        if (fd >= 0) {
+            loop.unwatch(fd);
+            tcsetattr(fd, TCSANOW, &saved);
+            close(fd);
+        }
+    }
+
+    // rs485: sürücü gönderim sırasında RTS ile yön denetimi yapar (TIOCSRS485). error açıklamayı verir.
+    bool open(const char *path, long baud, bool rs485, std::string &error) {
+        speed_t speed = baud_constant(baud);
+        if (speed == B0) return error = "desteklenmeyen hız: " + std::to_string(baud), false;
+        fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) return error = std::string(path) + ": " + std::strerror(errno), false;
+        termios tio;
+        if (tcgetattr(fd, &tio) != 0) return fail(error, "seri port değil");
+        saved = tio;
+        cfmakeraw(&tio);
+        tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 1;         // boş hatta read 0 değil EAGAIN döner; 0 kapanma demektir
+        tio.c_cc[VTIME] = 0;
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        if (tcsetattr(fd, TCSANOW, &tio) != 0) return fail(error, "port ayarlanamadı");
+        if (rs485) {
+            serial_rs485 conf{};
+            conf.flags = SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND;
+            if (ioctl(fd, TIOCSRS485, &conf) != 0) return fail(error, "RS-485 kipi açılamadı");
+        }
+        tcflush(fd, TCIOFLUSH);     // açılıştan önce hatta kalmış yarım komutlar atılır
+        if (!loop.watch(fd, EPOLLIN, [this](uint32_t ev) { on_event(ev); })) return fail(error, "olay döngüsüne eklenemedi");
+        return true;
+    }
+
+    std::function<void()> on_close;     // port kapandı ya da hata verdi (USB çevirici çıkarıldı, pty kapandı)
+    unsigned long commands_handled = 0;
+    unsigned long writes = 0;           // yanıt gönderimi için yapılan write sayısı
+    unsigned long overflows = 0;        // atılan çok uzun çerçeveler
+
+    const FrameRing &ring() const { return in; }
+
+private:
+    bool fail(std::string &error, const char *what) {
+        error = what;
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    void on_event(uint32_t ev) {
+        bool open = !(ev & EPOLLERR);
+        if (open && (ev & (EPOLLIN | EPOLLHUP))) open = read_frames();
+        if (open) open = flush();
+        if (!open) shut();
+    }
+
+    bool read_frames() {
+        for (int reads = 0; reading && reads < MAX_READS_PER_EVENT; ++reads) {
+            iovec iov[2];
+            int parts = in.space(iov);
+            if (!parts) break;      // halka dolu; çerçeveler işlendikten sonra yer açılır
+            ssize_t n = readv(fd, iov, parts);
+            if (n == 0) return false;       // hat kapandı
+            if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            in.produced(n);
+            in.frames([this](std::string_view frame) { handle_frame(frame); },
+                      [this] {
+                          ++overflows;
+                          append_reply("Hatalı komut! Komut çok uzun.\n");
+                      });
+            if (out.size() > MAX_PENDING_OUT) reading = false;
+        }
+        return true;
+    }
+
+    void handle_frame(std::string_view frame) {
+        reply.clear();
+        controller.handle_line(frame, reply, TRACE_SOURCE_SERIAL);
+        ++commands_handled;
+        append_reply(reply.view());
+    }
+
+    // Yanıtın son satır sonu protokoldeki '\r' ile değiştirilir.
+    void append_reply(std::string_view r) {
+        if (!r.empty() && r.back() == '\n') r.remove_suffix(1);
+        out.append(r.data(), r.size());
+        out.push_back('\r');
+    }
+
+    // Bir olayda biriken bütün yanıtlar tek write ile gönderilir.
+    bool flush() {
+        if (!out.empty()) {
+            ssize_t n = write(fd, out.data(), out.size());
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+            if (n > 0) {
+                out.erase(0, n);
+                ++writes;
+            }
+        }
+        uint32_t ev = 0;
+        if (!out.empty()) ev |= EPOLLOUT;
+        if (out.size() <= MAX_PENDING_OUT) {
+            reading = true;
+            ev |= EPOLLIN;
+        }
+        if (ev != events) {
+            loop.modify(fd, ev);
+            events = ev;
+        }
+        return true;
+    }
+
+    void shut() {
+        loop.unwatch(fd);
+        close(fd);
+        fd = -1;
+        if (on_close) on_close();
+    }
+
+    EventLoop &loop;
+    Controller &controller;
+    int fd = -1;
+    termios saved{};
+    FrameRing in;
+    std::string out;
+    ReplyBuffer reply;
+    bool reading = true;
+    uint32_t events = EPOLLIN;
+};
@@ -0,0 +1,203 @@
+// Komut sunucusu yük testi. Birden çok istemci bağlantısı açar, her biri belirlenen hızda
+// boru hattı (pipeline) halinde komut gönderir ve '\r' ile biten yanıtları sayar.
+// Komut başına gecikmenin p50/p99 değerlerini ve toplam iş hacmini raporlar. Yükün mod zamanlamasına
+// etkisi, çalışmadan önce ve sonra alınan GETSTATS'teki adım gecikmesinden (step_late_us) raporlanır.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target server_loadtest
+// Kullanım: server_loadtest (--unix PATH | --tcp HOST:PORT) [--clients 8] [--rate 5000] [--pipeline 4] [--seconds 5]
+//           --rate toplam komut/saniye hedefidir.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using steady = std::chrono::steady_clock;
+
+static const char *const mix[] = {"GETSIGNALGROUP\r", "GETMODE\r", "GETVERSION\r", "GETORDER\r", "GETSIGNALGROUP\r",
+                                   "GETMINSEQTIMEOUT\r", "GETSIGNALGROUP\r", "GETGPIOSTATS\r"};
+
+struct Target {
+    std::string unix_path;
+    std::string host = "127.0.0.1";
+    int port = 0;
+};
+
+static int connect_to(const Target &t) {
+    if (!t.unix_path.empty()) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, t.unix_path.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(t.port);
+    inet_pton(AF_INET, t.host.c_str(), &addr.sin_addr);
+    if (connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// GETSTATS yanıtından "STATS.step_late_us=count:N,...,p99:X,...,max:Y" satırı.
+struct StepLate {
+    unsigned long count = 0;
+    double p99 = 0, max = 0;
+};
+
+static bool query_step_late(const Target &t, StepLate &s) {
+    int fd = connect_to(t);
+    if (fd < 0) return false;
+    std::string reply;
+    char buf[4096];
+    bool ok = write(fd, "GETSTATS\r", 9) == 9;
+    pollfd p = {fd, POLLIN, 0};
+    while (ok && reply.find('\r') == std::string::npos && poll(&p, 1, 2000) == 1) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        reply.append(buf, n);
+    }
+    close(fd);
+    size_t at = reply.find("STATS.step_late_us=");
+    if (at == std::string::npos) return false;
+    const char *line = reply.c_str() + at;
+    const char *c = std::strstr(line, "count:"), *p99 = std::strstr(line, ",p99:"), *max = std::strstr(line, ",max:");
+    if (!c || !p99 || !max) return false;
+    s.count = std::strtoul(c + 6, nullptr, 10);
+    s.p99 = std::atof(p99 + 5);
+    s.max = std::atof(max + 5);
+    return true;
+}
+
+struct Result {
+    std::vector<double> latencies_us;
+    unsigned long errors = 0;
+};
+
+// Her istemci sabit aralıklarla 'pipeline' komutluk bir grup gönderir ve bütün yanıtları bekler.
+// Gecikme grubun gönderildiği andan her yanıtın geldiği ana kadar ölçülür.
+static void client_loop(const Target &t, double batches_per_sec, int pipeline, double seconds, int id, Result &res) {
+    int fd = connect_to(t);
+    if (fd < 0) {
+        ++res.errors;
+        return;
+    }
+    auto interval = std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(1.0 / batches_per_sec));
+    auto end = steady::now() + std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(seconds));
+    auto next = steady::now();
+    std::string batch;
+    char buf[8192];
+    size_t k = id;
+    while (steady::now() < end) {
+        batch.clear();
+        for (int i = 0; i < pipeline; ++i) batch += mix[k++ % (sizeof(mix) / sizeof(mix[0]))];
+        auto sent = steady::now();
+        if (write(fd, batch.data(), batch.size()) != (ssize_t)batch.size()) {
+            ++res.errors;
+            break;
+        }
+        int pending = pipeline;
+        while (pending > 0) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) {
+                ++res.errors;
+                close(fd);
+                return;
+            }
+            auto now = steady::now();
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buf[i] != '\r') continue;
+                res.latencies_us.push_back(std::chrono::duration<double, std::micro>(now - sent).count());
+                --pending;
+            }
+        }
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+    close(fd);
+}
+
+static double percentile(std::vector<double> &v, double p) {
+    if (v.empty()) return 0;
+    size_t idx = std::min(v.size() - 1, (size_t)(p / 100.0 * v.size()));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+int main(int argc, char **argv) {
+    Target target;
+    int clients = 8, pipeline = 4;
+    double rate = 5000, seconds = 5;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--unix" && i + 1 < argc) target.unix_path = argv[++i];
+        else if (a == "--tcp" && i + 1 < argc) {
+            std::string hp = argv[++i];
+            size_t colon = hp.rfind(':');
+            target.host = hp.substr(0, colon);
+            target.port = std::atoi(hp.c_str() + colon + 1);
+        } else if (a == "--clients" && i + 1 < argc) clients = std::atoi(argv[++i]);
+        else if (a == "--rate" && i + 1 < argc) rate = std::atof(argv[++i]);
+        else if (a == "--pipeline" && i + 1 < argc) pipeline = std::atoi(argv[++i]);
+        else if (a == "--seconds" && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else {
+            std::fprintf(stderr, "Kullanım: %s (--unix PATH | --tcp HOST:PORT) [--clients N] [--rate CMD/S] [--pipeline N] [--seconds S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (target.unix_path.empty() && !target.port) {
+        std::fprintf(stderr, "--unix ya da --tcp gerekli\n");
+        return 1;
+    }
+
+    StepLate before, after;
+    bool stats = query_step_late(target, before);
+    std::vector<Result> results(clients);
+    std::vector<std::thread> threads;
+    double batches_per_client = rate / pipeline / clients;
+    auto start = steady::now();
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back(client_loop, std::cref(target), batches_per_client, pipeline, seconds, c, std::ref(results[c]));
+    }
+    for (auto &t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(steady::now() - start).count();
+    stats = query_step_late(target, after) && stats;
+
+    std::vector<double> all;
+    unsigned long errors = 0;
+    for (auto &r : results) {
+        all.insert(all.end(), r.latencies_us.begin(), r.latencies_us.end());
+        errors += r.errors;
+    }
+    size_t total = all.size();
+    double p50 = percentile(all, 50), p99 = percentile(all, 99), p999 = percentile(all, 99.9);
+    double max = all.empty() ? 0 : *std::max_element(all.begin(), all.end());
+    std::printf("clients,pipeline,target_rate,commands,throughput_per_s,p50_us,p99_us,p999_us,max_us,errors,"
+                "steps,step_late_p99_us,step_late_max_before_us,step_late_max_after_us\n");
+    std::printf("%d,%d,%.0f,%zu,%.0f,%.1f,%.1f,%.1f,%.1f,%lu,", clients, pipeline, rate, total, total / elapsed, p50, p99,
+                p999, max, errors);
+    if (stats) std::printf("%lu,%.1f,%.1f,%.1f\n", after.count - before.count, after.p99, before.max, after.max);
+    else std::printf(",,,\n");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+// Kavşak durumunun /dev/shm üzerinden dışa verilmesi. Aynı kartta çalışan süreçler (RTU ajanı,
+// donanım bekçisi, yerel ekran) durumu komut göndermeden, sistem çağrısı yapmadan ve kontrolcüyü
+// yüklemeden okur. Bu başlık kontrolcünün geri kalanına bağlı değildir; okuyan süreçler yalnızca
+// bunu derler.
+//
+// Yazım seqlock ile korunur: yazıcı seq'i tek sayıya çıkarır, durumu kopyalar ve seq'i çift sayıya
+// getirir. Okuyucu seq'i okur, durumu kopyalar ve seq değişmediyse kopyayı kullanır; değiştiyse ya
+// da tek ise yeniden dener. Tek yazıcı vardır; okuyucu sayısı ve okuma sıklığı yazıcıyı etkilemez.
+
+struct JunctionState {
+    uint64_t outputs;               // çıkış maskesi (kafa başına 3 bit: R, Y, G; ardından durum LED'i)
+    uint64_t transitions;           // yapılan geçiş sayısı
+    uint64_t commands;              // işlenen komut sayısı
+    uint64_t conflicts;             // çakışma denetiminin reddettiği çıkışlar
+    uint64_t heartbeat;             // her yayında artar
+    int64_t updated_ns;             // son yayın, CLOCK_MONOTONIC
+    int64_t step_deadline_ns;       // çalışan adımın bitişi, CLOCK_MONOTONIC
+    int64_t civil_seconds;          // kontrolcünün takvim saati (SETTIME dahil), epoch saniyesi
+    uint32_t step;                  // çalışan planın adım sırası
+    uint32_t step_count;            // plandaki adım sayısı
+    uint32_t plan_version;          // sıra değişikliğiyle artan plan sürümü
+    uint32_t step_late_max_us;      // adım geçişlerinin planlanan andan en büyük sapması
+    uint32_t gpio_commit_max_us;    // en uzun toplu GPIO yazması
+    uint8_t mode;                   // yürütülen mod (Mode)
+    uint8_t activemode;             // seçili mod (Mode)
+    uint8_t head_count;
+    uint8_t reserved0;
+    char mode_name[32];             // GETMODE'daki ad; PLAN modunda plan adı
+    uint8_t reserved[136];
+};
+static_assert(sizeof(JunctionState) == 256, "durum boyutu segment biçiminin parçasıdır");
+
+struct ShmStateHeader {
+    char magic[8];                      // "JCSHM001"
+    uint32_t version;
+    uint32_t state_size;
+    int32_t pid;                        // yazan kontrolcü; 0: düzgün kapandı
+    uint32_t reserved[3];
+    alignas(64) std::atomic<uint64_t> seq;      // tek: yazım sürüyor
+    alignas(64) JunctionState state;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seq paylaşımlı bellekte kilitsiz olmalı");
+
+constexpr char SHM_STATE_MAGIC[8] = {'J', 'C', 'S', 'H', 'M', '0', '0', '1'};
+constexpr uint32_t SHM_STATE_VERSION = 1;
+constexpr const char *SHM_STATE_DEFAULT_NAME = "/junction_state";
+
+// Kontrolcü tarafı. Segment açılışta oluşturulur ya da yeniden kullanılır; okuyucuların eski
+// eşlemeleri geçerli kalır.
+class ShmStateWriter {
+public:
+    ~ShmStateWriter() {
+        if (header) munmap(header, sizeof(ShmStateHeader));
+    }
+
+    bool open(const char *name) {
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, sizeof(ShmStateHeader)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, sizeof(ShmStateHeader), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        header = static_cast<ShmStateHeader *>(p);
+        if (std::memcmp(header->magic, SHM_STATE_MAGIC, 8) != 0 || header->version != SHM_STATE_VERSION) {
+            std::memset(p, 0, sizeof(ShmStateHeader));
+            header->version = SHM_STATE_VERSION;
+            header->state_size = sizeof(JunctionState);
+            std::memcpy(header->magic, SHM_STATE_MAGIC, 8);
+        }
+        uint64_t s = header->seq.load(std::memory_order_relaxed);
+        if (s & 1) header->seq.store(s + 1, std::memory_order_release);     // önceki yazıcı yazarken öldü
+        header->pid = getpid();
+        return true;
+    }
+
+    bool is_open() const { return header != nullptr; }
+
+    void publish(const JunctionState &s) {
+        if (!header) return;
+        uint64_t seq = header->seq.load(std::memory_order_relaxed);
+        header->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);        // tek seq, durumdan önce görünür
+        std::memcpy(&header->state, &s, sizeof(s));
+        header->seq.store(seq + 2, std::memory_order_release);
+        ++publishes;
+    }
+
+    // Düzgün kapanış: okuyucular pid 0'ı görür, son durum yerinde kalır.
+    void close_clean() {
+        if (header) header->pid = 0;
+    }
+
+    unsigned long publishes = 0;
+
+private:
+    ShmStateHeader *header = nullptr;
+};
+
+// Okuyucu tarafı. Segment salt okunur eşlenir; read() kilit ve sistem çağrısı kullanmaz.
+class ShmStateReader {
+public:
+    static constexpr unsigned MAX_RETRIES = 1000;
+
+    ~ShmStateReader() {
+        if (header) munmap(const_cast<ShmStateHeader *>(header), sizeof(ShmStateHeader));
+    }
+
+    // Segment yoksa ya da biçimi farklıysa false döner; error açıklamayı verir.
+    bool open(const char *name, const char **error = nullptr) {
+        const char *unused;
+        const char *&err = error ? *error : unused;
+        int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) return err = "segment bulunamadı", false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmStateHeader)) {
+            ::close(fd);
+            return err = "segment boyutu hatalı", false;
+        }
+        void *p = mmap(nullptr, sizeof(ShmStateHeader), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return err = "segment eşlenemedi", false;
+        header = static_cast<const ShmStateHeader *>(p);
+        if (std::memcmp(header->magic, SHM_STATE_MAGIC, 8) != 0 || header->version != SHM_STATE_VERSION ||
+            header->state_size != sizeof(JunctionState)) {
+            munmap(p, sizeof(ShmStateHeader));
+            header = nullptr;
+            return err = "segment sürümü desteklenmiyor", false;
+        }
+        return true;
+    }
+
+    bool is_open() const { return header != nullptr; }
+
+    // Tutarlı bir kopya alır. Yazıcı sürekli yazıyorsa MAX_RETRIES denemeden sonra false döner.
+    bool read(JunctionState &out) {
+        if (!header) return false;
+        for (unsigned i = 0; i < MAX_RETRIES; ++i) {
+            uint64_t s1 = header->seq.load(std::memory_order_acquire);
+            if (!(s1 & 1)) {
+                std::memcpy(&out, &header->state, sizeof(out));
+                std::atomic_thread_fence(std::memory_order_acquire);    // kopya, ikinci seq okumasından önce biter
+                if (header->seq.load(std::memory_order_relaxed) == s1) return true;
+            }
+            ++retries;
+        }
+        return false;
+    }
+
+    // Yazıcı çalışıyor mu: pid 0 değilse ve süreç varsa. Bekçi ayrıca updated_ns'nin tazeliğine bakar.
+    bool writer_alive() const { return header && header->pid > 0 && kill(header->pid, 0) == 0; }
+
+    // Son yayından bu yana geçen süre (ns), okuyanın CLOCK_MONOTONIC'ine göre.
+    static int64_t age_ns(const JunctionState &s) {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec - s.updated_ns;
+    }
+
+    unsigned long retries = 0;      // yazıcıyla çakışan okuma denemeleri
+
+private:
+    const ShmStateHeader *header = nullptr;
+};
@@ -0,0 +1,82 @@
+// /dev/shm durum segmenti okuyucusu. Kontrolcünün --shm ile yayınladığı durumu komut göndermeden
+// okur; RTU ajanı, bekçi ya da ekran için örnek okuyucudur. --watch ile belirtilen aralıkla okur ve
+// yalnızca değişen durumları yazar. Bekçi kipinde (--max-age) kontrolcü çalışmıyorsa ya da son yayın
+// verilen süreden eskiyse çıkış kodu 2'dir.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target shm_state_dump
+// Kullanım: shm_state_dump [NAME] [--watch MS] [--csv] [--max-age MS]
+
+#include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "output_mask.h"
+#include "shm_state.h"
+
+static void print_state(const JunctionState &s, bool csv) {
+    double age_ms = ShmStateReader::age_ns(s) / 1e6;
+    if (csv) {
+        std::printf("%llu,%s,%u,%u,%u,", (unsigned long long)s.heartbeat, s.mode_name, s.step, s.step_count, s.plan_version);
+        for (int h = 0; h < s.head_count; ++h) std::printf("%s%s", h ? "|" : "", signal_name(get_head(s.outputs, h)));
+        std::printf(",%llu,%llu,%llu,%u,%u,%.1f\n", (unsigned long long)s.transitions, (unsigned long long)s.commands,
+                    (unsigned long long)s.conflicts, s.step_late_max_us, s.gpio_commit_max_us, age_ms);
+        return;
+    }
+    std::printf("MODE=%s step:%u/%u version:%u ", s.mode_name, s.step + 1, s.step_count, s.plan_version);
+    for (int h = 0; h < s.head_count; ++h) std::printf("%st%d:%s", h ? ", " : "", h + 1, signal_name(get_head(s.outputs, h)));
+    std::printf(" | transitions:%llu commands:%llu conflicts:%llu late_max:%uus gpio_max:%uus age:%.1fms\n",
+                (unsigned long long)s.transitions, (unsigned long long)s.commands, (unsigned long long)s.conflicts,
+                s.step_late_max_us, s.gpio_commit_max_us, age_ms);
+}
+
+int main(int argc, char **argv) {
+    const char *name = SHM_STATE_DEFAULT_NAME;
+    long watch_ms = 0, max_age_ms = 0;
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--watch") == 0 && i + 1 < argc) watch_ms = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-age") == 0 && i + 1 < argc) max_age_ms = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--csv") == 0) csv = true;
+        else if (argv[i][0] == '/') name = argv[i];
+        else {
+            std::fprintf(stderr, "Kullanım: %s [NAME] [--watch MS] [--csv] [--max-age MS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    ShmStateReader reader;
+    const char *error = nullptr;
+    if (!reader.open(name, &error)) {
+        std::fprintf(stderr, "%s: %s\n", name, error);
+        return 1;
+    }
+    if (csv) std::printf("heartbeat,mode,step,steps,version,heads,transitions,commands,conflicts,step_late_max_us,gpio_max_us,age_ms\n");
+
+    JunctionState s, last = {};
+    do {
+        if (!reader.read(s)) {
+            std::fprintf(stderr, "Tutarlı okuma yapılamadı (%lu deneme)\n", reader.retries);
+            return 1;
+        }
+        if (max_age_ms > 0 && !reader.writer_alive()) {
+            std::fprintf(stderr, "Kontrolcü çalışmıyor\n");
+            return 2;
+        }
+        if (max_age_ms > 0 && ShmStateReader::age_ns(s) > max_age_ms * 1000000) {
+            std::fprintf(stderr, "Kontrolcü yanıt vermiyor: son yayın %.1f ms önce\n", ShmStateReader::age_ns(s) / 1e6);
+            return 2;
+        }
+        // heartbeat dışındaki alanlar değişmediyse yazılmaz
+        if (!watch_ms || s.outputs != last.outputs || s.step != last.step || std::strcmp(s.mode_name, last.mode_name) != 0) {
+            print_state(s, csv);
+            std::fflush(stdout);
+        }
+        last = s;
+        if (watch_ms) {
+            timespec ts = {watch_ms / 1000, (watch_ms % 1000) * 1000000};
+            nanosleep(&ts, nullptr);
+        }
+    } while (watch_ms);
+    return 0;
+}
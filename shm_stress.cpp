@@ -0,0 +1,120 @@
+// /dev/shm seqlock zorlama testi. Bir yazıcı iş parçacığı durumu aralıksız (ya da --period-us ile
+// belirtilen aralıkla) yayınlar; okuyucu iş parçacıkları aynı segmenti ayrı eşlemelerle okur ve her
+// kopyanın tutarlı olduğunu denetler. Her yayındaki bütün alanlar tek bir sayaçtan türetildiğinden
+// yarım kalmış bir kopya hemen fark edilir. Sonuçlar CSV olarak verilir; yırtık okuma ya da geri giden
+// heartbeat görülürse çıkış kodu 1'dir.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target shm_stress
+// Kullanım: shm_stress [--readers N] [--seconds S] [--period-us US]
+
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shm_state.h"
+
+static void fill_state(JunctionState &s, uint64_t k) {
+    std::memset(&s, int(k & 0xff), sizeof(s));
+    s.outputs = k;
+    s.transitions = ~k;
+    s.commands = k * 3;
+    s.conflicts = k ^ 0x5555555555555555ull;
+    s.heartbeat = k;
+    s.updated_ns = int64_t(k);
+    s.step_deadline_ns = -int64_t(k);
+    s.civil_seconds = int64_t(k) + 1;
+    s.step = uint32_t(k);
+    s.step_count = uint32_t(k >> 32);
+    std::snprintf(s.mode_name, sizeof(s.mode_name), "K%020llu", (unsigned long long)k);
+}
+
+static bool consistent(const JunctionState &s) {
+    JunctionState expect;
+    fill_state(expect, s.heartbeat);
+    return std::memcmp(&s, &expect, sizeof(s)) == 0;
+}
+
+struct ReaderResult {
+    unsigned long reads = 0, torn = 0, backwards = 0, failed = 0, retries = 0;
+};
+
+int main(int argc, char **argv) {
+    int readers = 4;
+    double seconds = 2;
+    long period_us = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--readers") == 0 && i + 1 < argc) readers = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--period-us") == 0 && i + 1 < argc) period_us = std::atol(argv[++i]);
+        else {
+            std::fprintf(stderr, "Kullanım: %s [--readers N] [--seconds S] [--period-us US]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::string name = "/junction_stress_" + std::to_string(getpid());
+    ShmStateWriter writer;
+    if (!writer.open(name.c_str())) {
+        std::fprintf(stderr, "Segment oluşturulamadı: %s\n", name.c_str());
+        return 1;
+    }
+    JunctionState s;
+    fill_state(s, 0);
+    writer.publish(s);
+
+    std::atomic<bool> stop{false};
+    std::vector<ReaderResult> results(readers);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            ShmStateReader reader;
+            if (!reader.open(name.c_str())) return;
+            ReaderResult &res = results[r];
+            JunctionState got;
+            uint64_t last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!reader.read(got)) {
+                    ++res.failed;
+                    continue;
+                }
+                ++res.reads;
+                if (!consistent(got)) ++res.torn;
+                if (got.heartbeat < last) ++res.backwards;
+                last = got.heartbeat;
+            }
+            res.retries = reader.retries;
+        });
+    }
+
+    uint64_t k = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    auto end = t0 + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        fill_state(s, ++k);
+        writer.publish(s);
+        if (period_us) std::this_thread::sleep_for(std::chrono::microseconds(period_us));
+    }
+    stop = true;
+    for (auto &t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    shm_unlink(name.c_str());
+
+    ReaderResult total;
+    for (const ReaderResult &r : results) {
+        total.reads += r.reads;
+        total.torn += r.torn;
+        total.backwards += r.backwards;
+        total.failed += r.failed;
+        total.retries += r.retries;
+    }
+    std::printf("readers,seconds,writes,writes_per_sec,reads,reads_per_sec,retries,failed,torn,backwards\n");
+    std::printf("%d,%.2f,%llu,%.0f,%lu,%.0f,%lu,%lu,%lu,%lu\n", readers, elapsed, (unsigned long long)k, k / elapsed, total.reads,
+                total.reads / elapsed, total.retries, total.failed, total.torn, total.backwards);
+    return total.torn || total.backwards || total.reads == 0;
+}
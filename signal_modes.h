@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "gpio_output.h"
+#include "signal_plan.h"
+
+enum class Mode { NONE, SEQUENCE, FLASH, PHASE, PLAN };      // PLAN: dosyadan yüklenen plan
+
+inline const char *mode_name(Mode m) {
+    switch (m) {
+        case Mode::SEQUENCE: return "SEQUENCE";
+        case Mode::FLASH: return "FLASH";
+        case Mode::PHASE: return "PHASE";
+        case Mode::PLAN: return "PLAN";
+        default: return "NONE";
+    }
+}
+
+inline Mode parse_mode(std::string_view name) {
+    if (name == "SEQUENCE") return Mode::SEQUENCE;
+    if (name == "FLASH") return Mode::FLASH;
+    if (name == "PHASE") return Mode::PHASE;
+    return Mode::NONE;
+}
+
+// Derlenmiş plan tablosunu gezen yürütücü. Uyumaz ve iş parçacığı açmaz; çağıran her adımın çıkışını
+// uygular ve bir sonraki adımı adımın süresi dolunca ister. Adım başına iş plan ne olursa olsun sabittir.
+struct PlanExecutor {
+    const SignalPlan *plan = nullptr;
+    size_t index = 0;
+    std::mt19937 gen{std::random_device{}()};       // dedektörsüz değişken yeşiller için
+
+    void start(const SignalPlan *p) {
+        plan = p && !p->steps.empty() ? p : nullptr;
+        index = 0;
+    }
+
+    bool running() const { return plan != nullptr; }
+    const PlanStep &current() const { return plan->steps[index]; }
+
+    // Değişken adımın süresi tam saniyelerle min-max arasından seçilir (eski PHASE davranışı).
+    std::chrono::milliseconds duration() {
+        const PlanStep &s = current();
+        if (s.max_ms == s.min_ms) return std::chrono::milliseconds(s.min_ms);
+        std::uniform_int_distribution<uint32_t> dist(0, (s.max_ms - s.min_ms) / 1000);
+        return std::chrono::milliseconds(s.min_ms + dist(gen) * 1000);
+    }
+
+    void advance() {
+        if (++index == plan->steps.size()) index = 0;
+    }
+};
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "conflict_monitor.h"
+#include "inline_storage.h"
+#include "output_mask.h"
+#include "time_schedule.h"
+
+// Sinyal planı: bir kez derlenen düz bir adım tablosu. Her adım bütün grupların çıkış maskesini ve
+// süresini tutar; yürütücü tabloyu sırayla gezer, adım başına iş sabittir ve plan karmaşıklığına bağlı
+// değildir. Planlar dosyadan okunur ya da SEQUENCE/PHASE/FLASH için sıradan üretilir.
+
+constexpr int MAX_GROUPS = 16;                  // maske ve anlık durum 16 grup x 3 bit taşır
+constexpr int MAX_PLAN_STAGES = 32;
+constexpr int MAX_PLAN_STEPS = 3 * MAX_PLAN_STAGES;     // aşama başına yeşil, sarı, kırmızı+sarı
+
+using PlanName = InlineString<32>;                  // durum kaydı ve /dev/shm alanıyla aynı uzunluk
+using GroupOrder = InlineVector<int, MAX_GROUPS>;   // SEQUENCE/PHASE yön sırası
+
+enum PlanStepFlags : uint8_t {
+    STEP_SAFE_POINT = 1,        // adımın sonu plan değişikliği için güvenli sınır (kırmızı+sarı sonu)
+};
+
+struct PlanStep {
+    OutputMask outputs;
+    uint32_t min_ms;            // sabit adımlarda min_ms == max_ms
+    uint32_t max_ms;            // değişken yeşil: dedektör varsa talebe göre, yoksa rastgele seçilir
+    int8_t detector;            // süreyi belirleyen grubun dedektörü, yoksa -1
+    uint8_t flags;
+};
+
+// Adımlar planın içinde durur: planı kopyalamak ya da yeniden derlemek bellek ayırmaz.
+struct SignalPlan {
+    PlanName name;
+    int groups = 0;
+    InlineVector<PlanStep, MAX_PLAN_STEPS> steps;
+};
+
+// Plan tanımı: aşamalar (birlikte yeşil yanan gruplar) ve geçiş süreleri. Derleyici aşamalar arasına
+// sarı ve kırmızı+sarı adımlarını kendisi ekler. Yaya gruplarında sarı yoktur; biten yaya grubu sarı
+// adımında kırmızıya, başlayan yaya grubu yeşile doğrudan geçer.
+struct PlanStage {
+    uint32_t groups;            // bit i: grup i yeşil
+    uint32_t min_ms;
+    uint32_t max_ms;
+    int8_t detector;
+};
+
+struct PlanSpec {
+    PlanName name;
+    int groups = 0;
+    uint32_t pedestrian = 0;        // bit i: grup i yaya grubu
+    uint32_t yellow_ms = 2000;
+    uint32_t red_yellow_ms = 2000;
+    InlineVector<PlanStage, MAX_PLAN_STAGES> stages;
+    InlineVector<PlanStep, MAX_PLAN_STEPS> steps;    // ham adımlar (aşamalarla birlikte kullanılmaz)
+};
+
+inline char signal_char(unsigned sig) {
+    switch (sig) {
+        case SIG_GREEN: return 'G';
+        case SIG_YELLOW: return 'Y';
+        case SIG_RED: return 'R';
+        case SIG_RED_YELLOW: return 'U';
+        default: return '-';
+    }
+}
+
+inline int parse_signal_char(char c) {
+    switch (c) {
+        case 'G': return SIG_GREEN;
+        case 'Y': return SIG_YELLOW;
+        case 'R': return SIG_RED;
+        case 'U': return SIG_RED_YELLOW;
+        case '-': return SIG_OFF;
+        default: return -1;
+    }
+}
+
+// Bir sonraki adımda yeşile geçen grup varsa adımın sonu güvenli sınırdır. Hiç yeşil olmayan
+// planlarda (FLASH gibi) çevrim sonu kullanılır.
+inline void mark_safe_points(SignalPlan &plan) {
+    size_t n = plan.steps.size();
+    bool any = false;
+    for (size_t i = 0; i < n; ++i) {
+        OutputMask cur = plan.steps[i].outputs, next = plan.steps[(i + 1) % n].outputs;
+        bool starts_green = false;
+        for (int g = 0; g < plan.groups; ++g) {
+            if (get_head(next, g) == SIG_GREEN && get_head(cur, g) != SIG_GREEN) starts_green = true;
+        }
+        plan.steps[i].flags = starts_green ? STEP_SAFE_POINT : 0;
+        any |= starts_green;
+    }
+    if (!any && n) plan.steps[n - 1].flags |= STEP_SAFE_POINT;
+}
+
+inline OutputMask stage_mask(const PlanSpec &spec, uint32_t green) {
+    OutputMask m = 0;
+    for (int g = 0; g < spec.groups; ++g) m = set_head(m, g, (green >> g) & 1 ? SIG_GREEN : SIG_RED);
+    return m;
+}
+
+// Tanımı düz tabloya çevirir. Tanım önceden validate_plan() ile doğrulanmış olmalıdır.
+inline SignalPlan compile_plan(const PlanSpec &spec) {
+    SignalPlan plan;
+    plan.name = spec.name;
+    plan.groups = spec.groups;
+    if (spec.stages.empty()) {
+        plan.steps = spec.steps;
+        mark_safe_points(plan);
+        return plan;
+    }
+    size_t n = spec.stages.size();
+    for (size_t i = 0; i < n; ++i) {
+        const PlanStage &cur = spec.stages[i], &next = spec.stages[(i + 1) % n];
+        plan.steps.push_back({stage_mask(spec, cur.groups), cur.min_ms, cur.max_ms, cur.detector, 0});
+        uint32_t ending = cur.groups & ~next.groups, starting = next.groups & ~cur.groups;
+        if (!ending && !starting) continue;     // aynı gruplar yanmaya devam eder
+        OutputMask yellow = stage_mask(spec, cur.groups & next.groups);
+        OutputMask red_yellow = yellow;
+        for (int g = 0; g < spec.groups; ++g) {
+            bool ped = (spec.pedestrian >> g) & 1;
+            if ((ending >> g) & 1 && !ped) yellow = set_head(yellow, g, SIG_YELLOW);
+            if ((starting >> g) & 1 && !ped) red_yellow = set_head(red_yellow, g, SIG_RED_YELLOW);
+        }
+        plan.steps.push_back({yellow, spec.yellow_ms, spec.yellow_ms, -1, 0});
+        plan.steps.push_back({red_yellow, spec.red_yellow_ms, spec.red_yellow_ms, -1, 0});
+    }
+    mark_safe_points(plan);
+    return plan;
+}
+
+// Tanımı yürütmeden önce denetler; hata varsa açıklamasını error'a yazar.
+inline bool validate_plan(const PlanSpec &spec, std::string &error) {
+    if (spec.name.empty()) return error = "plan adı boş", false;
+    if (spec.groups < 1 || spec.groups > MAX_GROUPS) return error = "grup sayısı 1-16 arasında olmalı", false;
+    if (spec.stages.empty() == spec.steps.empty()) return error = "plan ya aşamalardan (stage) ya da adımlardan (step) oluşmalı", false;
+    uint32_t all = (1u << spec.groups) - 1;
+    if (spec.pedestrian & ~all) return error = "yaya grubu grup sayısını aşıyor", false;
+    if (spec.yellow_ms == 0 || spec.red_yellow_ms == 0) return error = "sarı ve kırmızı+sarı süreleri sıfır olamaz", false;
+    for (const PlanStage &s : spec.stages) {
+        if (!s.groups || (s.groups & ~all)) return error = "aşamada geçersiz grup", false;
+        if (s.min_ms == 0 || s.min_ms > s.max_ms) return error = "aşama süresi geçersiz", false;
+        if (s.detector >= spec.groups) return error = "dedektör grup sayısını aşıyor", false;
+    }
+    for (const PlanStep &s : spec.steps) {
+        if (s.min_ms == 0 || s.min_ms > s.max_ms) return error = "adım süresi geçersiz", false;
+        for (int g = 0; g < spec.groups; ++g) {
+            unsigned sig = get_head(s.outputs, g);
+            if ((spec.pedestrian >> g) & 1 && (sig & SIG_YELLOW)) return error = "yaya grubunda sarı kullanılamaz", false;
+        }
+    }
+    return true;
+}
+
+// SEQUENCE ve PHASE planları: sıradaki her yön ayrı bir aşama. green_min < green_max ise yeşil
+// değişkendir ve yönün kendi dedektörüne bağlanır.
+inline SignalPlan order_plan(const char *name, const int *order, size_t count, int groups, int green_min, int green_max) {
+    PlanSpec spec;
+    spec.name = name;
+    spec.groups = groups;
+    for (size_t i = 0; i < count; ++i) {
+        int g = order[i];
+        spec.stages.push_back({1u << g, uint32_t(green_min) * 1000, uint32_t(green_max) * 1000, int8_t(green_min < green_max ? g : -1)});
+    }
+    if (spec.stages.empty()) return {name, groups, {}};
+    return compile_plan(spec);
+}
+
+inline SignalPlan flash_plan(int groups) {
+    SignalPlan plan{"FLASH", groups, {}};
+    plan.steps.push_back({all_heads(groups, SIG_YELLOW), 1000, 1000, -1, 0});
+    plan.steps.push_back({all_heads(groups, SIG_OFF), 1000, 1000, -1, 0});
+    mark_safe_points(plan);
+    return plan;
+}
+
+// Planı iki çevrim boyunca en kısa sürelerle yürütüp çakışma kurallarına uyduğunu denetler.
+inline bool check_plan_conflicts(const SignalPlan &plan, const ConflictRules &rules, std::string &error) {
+    if (plan.groups > rules.groups) return error = std::string(plan.name) + ": grup sayısı çakışma kurallarını aşıyor", false;
+    ConflictMonitor monitor(rules);
+    Clock::time_point t{};
+    for (size_t k = 0; k < 2 * plan.steps.size(); ++k) {
+        const PlanStep &s = plan.steps[k % plan.steps.size()];
+        if (!monitor.admit(s.outputs, t)) {
+            error = std::string(plan.name) + ": adım " + std::to_string(k % plan.steps.size() + 1) + ": " + describe_conflict(monitor.last);
+            return false;
+        }
+        t += std::chrono::milliseconds(s.min_ms);
+    }
+    return true;
+}
+
+// "1,2,5" gibi 1 tabanlı grup listesi.
+inline bool parse_group_list(std::string_view s, int groups, uint32_t &out) {
+    out = 0;
+    while (!s.empty()) {
+        size_t comma = s.find(',');
+        std::string_view part = s.substr(0, comma);
+        int g = 0;
+        if (part.empty() || part.size() > 2) return false;
+        for (char c : part) {
+            if (c < '0' || c > '9') return false;
+            g = g * 10 + (c - '0');
+        }
+        if (g < 1 || g > groups || (out >> (g - 1)) & 1) return false;
+        out |= 1u << (g - 1);
+        if (comma == std::string_view::npos) break;
+        s.remove_prefix(comma + 1);
+    }
+    return out != 0;
+}
+
+// Saniye, ondalıklı olabilir: "2", "1.5".
+inline bool parse_seconds_ms(const std::string &s, uint32_t &ms) {
+    char *end;
+    double v = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || *end || v <= 0 || v > 3600) return false;
+    ms = uint32_t(v * 1000 + 0.5);
+    return true;
+}
+
+// "5" ya da "3-10" biçiminde yeşil süresi.
+inline bool parse_green_range(const std::string &s, uint32_t &min_ms, uint32_t &max_ms) {
+    size_t dash = s.find('-');
+    if (dash == std::string::npos) {
+        if (!parse_seconds_ms(s, min_ms)) return false;
+        max_ms = min_ms;
+        return true;
+    }
+    return parse_seconds_ms(s.substr(0, dash), min_ms) && parse_seconds_ms(s.substr(dash + 1), max_ms) && min_ms <= max_ms;
+}
+
+// Plan dosyasını okur, her planı doğrular ve derler. Satır biçimi:
+//   plan ADI                  yeni plan
+//   groups N                  grup sayısı (1-16)
+//   pedestrian 5,6            yaya grupları
+//   yellow 2 / redyellow 2    geçiş süreleri (saniye)
+//   stage 1,3 5               birlikte yeşil yanan gruplar ve yeşil süresi
+//   stage 2 3-10 detector 2   değişken yeşil, 2. grubun dedektörüne bağlı
+//   step GRRY 1.5             ham adım: G yeşil, Y sarı, R kırmızı, U kırmızı+sarı, - sönük
+//   end                       planı bitirir
+// Planlardan önce kavşağın çakışma kuralları yazılabilir (rules verildiyse her plan bunlara göre denetlenir):
+//   compatible 1,3            bu gruplar aynı anda yeşil yanabilir (varsayılan: hepsi çakışır)
+//   intergreen 3              çakışan gruplar arasında en kısa ara süre (saniye)
+//   intergreen 1 2 5          1'in yeşili bittikten sonra 2 için en az 5 saniye
+// '#' ile başlayan kısımlar açıklamadır. Hata varsa error "dosya:satır: açıklama" biçimindedir.
+inline bool load_plan_file(const char *path, std::vector<SignalPlan> &plans, std::string &error, ConflictRules *rules = nullptr,
+                           TimeSchedule *schedule = nullptr) {
+    FILE *f = std::fopen(path, "r");
+    if (!f) return error = std::string(path) + ": açılamadı", false;
+    PlanSpec spec;
+    bool open = false;
+    int lineno = 0;
+    char line[512];
+    auto fail = [&](const std::string &msg) {
+        std::fclose(f);
+        error = std::string(path) + ":" + std::to_string(lineno) + ": " + msg;
+        return false;
+    };
+    while (std::fgets(line, sizeof(line), f)) {
+        ++lineno;
+        if (char *hash = std::strchr(line, '#')) *hash = '\0';
+        std::vector<std::string> words;
+        for (char *tok = std::strtok(line, " \t\r\n"); tok; tok = std::strtok(nullptr, " \t\r\n")) words.push_back(tok);
+        if (words.empty()) continue;
+        const std::string &key = words[0];
+        if (key == "plan") {
+            if (open) return fail("önceki plan 'end' ile bitmedi");
+            if (words.size() != 2) return fail("plan adı bekleniyor");
+            if (words[1].size() > PlanName::MAX_LENGTH) return fail("plan adı en fazla 31 karakter olabilir");
+            for (const SignalPlan &p : plans) {
+                if (p.name == words[1]) return fail("aynı adla ikinci plan: " + words[1]);
+            }
+            spec = PlanSpec();
+            spec.name = words[1];
+            open = true;
+            continue;
+        }
+        if (!open && (key == "compatible" || key == "intergreen")) {
+            if (!plans.empty()) return fail("çakışma kuralları planlardan önce yazılmalı");
+            if (!rules) continue;
+            uint32_t set = 0, ms = 0;
+            if (key == "compatible" && words.size() == 2) {
+                if (!parse_group_list(words[1], rules->groups, set)) return fail("geçersiz grup listesi");
+                rules->set_compatible(set);
+            } else if (key == "intergreen" && words.size() == 2) {
+                if (!parse_seconds_ms(words[1], ms)) return fail("geçersiz süre");
+                rules->set_intergreen(ms);
+            } else if (key == "intergreen" && words.size() == 4) {
+                int from = std::atoi(words[1].c_str()), to = std::atoi(words[2].c_str());
+                if (from < 1 || from > rules->groups || to < 1 || to > rules->groups || from == to) return fail("geçersiz grup");
+                if (!parse_seconds_ms(words[3], ms)) return fail("geçersiz süre");
+                rules->intergreen_ms[from - 1][to - 1] = ms;
+            } else {
+                return fail("eksik tanım: " + key);
+            }
+            continue;
+        }
+        if (!open && key == "schedule") {
+            ScheduleEntry e;
+            if (words.size() != 4) return fail("çizelge satırı: schedule GÜNLER SS:DD MOD");
+            if (!parse_day_list(words[1], e.days)) return fail("geçersiz gün listesi");
+            if (!parse_time_of_day(words[2], e.second)) return fail("geçersiz saat");
+            e.target = words[3];
+            if (schedule) schedule->entries.push_back(e);
+            continue;
+        }
+        if (!open) return fail("'plan' satırından önce tanım");
+        if (key == "end") {
+            std::string why;
+            if (!validate_plan(spec, why)) return fail(std::string(spec.name) + ": " + why);
+            plans.push_back(compile_plan(spec));
+            if (rules && !check_plan_conflicts(plans.back(), *rules, why)) return fail(why);
+            open = false;
+        } else if (key == "groups" && words.size() == 2) {
+            spec.groups = std::atoi(words[1].c_str());
+            if (spec.groups < 1 || spec.groups > MAX_GROUPS) return fail("grup sayısı 1-16 arasında olmalı");
+        } else if (!spec.groups) {
+            return fail("önce 'groups' tanımlanmalı");
+        } else if (key == "pedestrian" && words.size() == 2) {
+            if (!parse_group_list(words[1], spec.groups, spec.pedestrian)) return fail("geçersiz grup listesi");
+        } else if (key == "yellow" && words.size() == 2) {
+            if (!parse_seconds_ms(words[1], spec.yellow_ms)) return fail("geçersiz süre");
+        } else if (key == "redyellow" && words.size() == 2) {
+            if (!parse_seconds_ms(words[1], spec.red_yellow_ms)) return fail("geçersiz süre");
+        } else if (key == "stage" && (words.size() == 3 || (words.size() == 5 && words[3] == "detector"))) {
+            PlanStage s{0, 0, 0, -1};
+            if (!parse_group_list(words[1], spec.groups, s.groups)) return fail("geçersiz grup listesi");
+            if (!parse_green_range(words[2], s.min_ms, s.max_ms)) return fail("geçersiz yeşil süresi");
+            if (words.size() == 5) {
+                int d = std::atoi(words[4].c_str());
+                if (d < 1 || d > spec.groups) return fail("geçersiz dedektör");
+                s.detector = int8_t(d - 1);
+            }
+            if (!spec.stages.push_back(s)) return fail("en fazla 32 aşama tanımlanabilir");
+        } else if (key == "step" && words.size() == 3) {
+            if ((int)words[1].size() != spec.groups) return fail("adım deseni grup sayısı kadar karakter olmalı");
+            PlanStep s{0, 0, 0, -1, 0};
+            for (int g = 0; g < spec.groups; ++g) {
+                int sig = parse_signal_char(words[1][g]);
+                if (sig < 0) return fail("geçersiz sinyal karakteri");
+                s.outputs = set_head(s.outputs, g, (unsigned)sig);
+            }
+            if (!parse_seconds_ms(words[2], s.min_ms)) return fail("geçersiz süre");
+            s.max_ms = s.min_ms;
+            if (!spec.steps.push_back(s)) return fail("en fazla 96 adım tanımlanabilir");
+        } else {
+            return fail("bilinmeyen ya da eksik tanım: " + key);
+        }
+    }
+    std::fclose(f);
+    if (open) {
+        error = std::string(path) + ": " + std::string(spec.name) + " planı 'end' ile bitmedi";
+        return false;
+    }
+    if (schedule) schedule->compile();
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include "output_mask.h"
+
+// Kavşağın çıkış maskesi (ilk 48 bit) ve bir sürüm numarası tek bir 64 bitlik atomik kelimede tutulur.
+// Yazıcı her geçişte kelimeyi tek store ile yayınlar; okuyucu tek load ile tutarlı bir görüntü alır,
+// kilit beklemez ve RED+GREEN gibi yarım kalmış durumlar göremez.
+class SignalSnapshot {
+public:
+    static constexpr int OUTPUT_BITS = 48;      // 16 kafaya kadar (kafa başına 3 bit)
+    static constexpr uint64_t OUTPUTS_MASK = (uint64_t(1) << OUTPUT_BITS) - 1;
+
+    struct View {
+        OutputMask outputs;
+        uint16_t version;       // her yayında artar (taşarak döner)
+    };
+
+    // Tek yazıcı varsayılır (geçişleri uygulayan iş parçacığı).
+    void publish(OutputMask outputs) {
+        uint64_t prev = word.load(std::memory_order_relaxed);
+        uint64_t version = (prev >> OUTPUT_BITS) + 1;
+        word.store((version << OUTPUT_BITS) | (outputs & OUTPUTS_MASK), std::memory_order_release);
+    }
+
+    View load() const {
+        uint64_t w = word.load(std::memory_order_acquire);
+        return {w & OUTPUTS_MASK, uint16_t(w >> OUTPUT_BITS)};
+    }
+
+private:
+    std::atomic<uint64_t> word{0};
+};
+
+// GETSIGNALGROUP yanıtı için önceden hazırlanmış parçalar: her kafa ve her durum için
+// "t2:GREEN" gibi metin bir kez üretilir, sorgu sırasında yalnızca kopyalanır.
+class SignalGroupFormatter {
+public:
+    static constexpr int MAX_HEADS = 16;
+    static constexpr size_t MAX_REPLY = MAX_HEADS * 20;
+
+    explicit SignalGroupFormatter(int head_count) : head_count(head_count < MAX_HEADS ? head_count : MAX_HEADS) {
+        for (int h = 0; h < this->head_count; ++h) {
+            for (unsigned sig = 0; sig < 8; ++sig) {
+                int n = std::snprintf(text[h][sig], sizeof(text[h][sig]), "%st%d:%s", h ? ", " : "", h + 1, signal_name(sig));
+                len[h][sig] = (uint8_t)n;
+            }
+        }
+    }
+
+    // Yanıtı out tamponuna yazar, uzunluğu döndürür. out en az MAX_REPLY bayt olmalıdır.
+    size_t format(OutputMask heads, char *out) const {
+        size_t n = 0;
+        for (int h = 0; h < head_count; ++h) {
+            unsigned sig = get_head(heads, h);
+            for (uint8_t i = 0; i < len[h][sig]; ++i) out[n + i] = text[h][sig][i];
+            n += len[h][sig];
+        }
+        return n;
+    }
+
+private:
+    int head_count;
+    char text[MAX_HEADS][8][20];
+    uint8_t len[MAX_HEADS][8];
+};
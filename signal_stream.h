@@ -0,0 +1,282 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <vector>
+
+#include "civil_clock.h"
+#include "event_loop.h"
+#include "gpio_output.h"
+#include "mode_runner.h"
+#include "signal_modes.h"
+#include "signal_snapshot.h"
+#include "spsc_queue.h"
+
+// SUBSCRIBE akışının bir satırı. Her geçiş bir kez kodlanır; bütün aboneler aynı çerçeveyi paylaşır
+// ve son referans bırakılınca çerçeve havuza döner. Tek iş parçacığında (olay döngüsü) kullanılır.
+struct StreamFrame {
+    static constexpr size_t CAPACITY = SignalGroupFormatter::MAX_REPLY + 128;
+    uint32_t refs = 0;
+    uint32_t len = 0;
+    char data[CAPACITY];
+};
+
+// Çerçeveler yeniden kullanılır; kararlı durumda geçiş başına bellek ayrılmaz.
+class FramePool {
+public:
+    FramePool() = default;
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+    ~FramePool() {
+        for (StreamFrame *f : spare) delete f;
+    }
+
+    // Çerçeveler başta ayrılır; abone kuyrukları en çok bu kadar çerçeve tuttukça geçiş yolu bellek
+    // ayırmaz (abone başına en çok SubscriberQueue::CAPACITY).
+    void reserve(size_t frames) {
+        spare.reserve(frames);
+        while (allocated < frames) {
+            spare.push_back(new StreamFrame);
+            ++allocated;
+        }
+    }
+
+    StreamFrame *acquire() {
+        StreamFrame *f;
+        if (spare.empty()) {
+            f = new StreamFrame;
+            ++allocated;
+        } else {
+            f = spare.back();
+            spare.pop_back();
+        }
+        f->refs = 1;
+        f->len = 0;
+        return f;
+    }
+
+    void ref(StreamFrame *f) { ++f->refs; }
+
+    void release(StreamFrame *f) {
+        if (--f->refs == 0) spare.push_back(f);
+    }
+
+    unsigned long allocated = 0;
+
+private:
+    std::vector<StreamFrame *> spare;
+};
+
+// Bir abonenin gönderilmeyi bekleyen çerçeveleri; sabit boyutlu halka. Dolduğunda en yeni bekleyen
+// çerçeve yenisiyle değiştirilir: her satır bütün kafaların durumunu taşıdığından atlanan ara durum
+// istemcinin son durumu bilmesini engellemez, sıra numarasındaki boşluk atlamayı gösterir. Yazılmakta
+// olan baştaki çerçeveye dokunulmaz. Yavaş bir istemci böylece belleği ve geçiş yolunu büyütemez.
+class SubscriberQueue {
+public:
+    static constexpr size_t CAPACITY = 64;
+
+    explicit SubscriberQueue(FramePool &pool) : pool(pool) {}
+    SubscriberQueue(const SubscriberQueue &) = delete;
+    SubscriberQueue &operator=(const SubscriberQueue &) = delete;
+    ~SubscriberQueue() {
+        for (size_t i = 0; i < count; ++i) pool.release(ring[(first + i) % CAPACITY]);
+    }
+
+    void push(StreamFrame *f) {
+        pool.ref(f);
+        if (count < CAPACITY) {
+            ring[(first + count++) % CAPACITY] = f;
+            return;
+        }
+        StreamFrame *&last = ring[(first + count - 1) % CAPACITY];
+        pool.release(last);
+        last = f;
+        ++dropped;
+    }
+
+    bool empty() const { return count == 0; }
+    bool mid_frame() const { return offset != 0; }
+
+    // skip çerçeveden sonraki en fazla max çerçeveyi writev için iov'a yazar, yazılan sayıyı döndürür.
+    int fill(iovec *iov, int max, size_t skip = 0) const {
+        int n = 0;
+        for (size_t i = skip; i < count && n < max; ++i, ++n) {
+            const StreamFrame *f = ring[(first + i) % CAPACITY];
+            size_t off = i == 0 ? offset : 0;
+            iov[n].iov_base = const_cast<char *>(f->data + off);
+            iov[n].iov_len = f->len - off;
+        }
+        return n;
+    }
+
+    // Gönderilen baytlar baştaki çerçevelerden düşülür, en fazla max_frames çerçeve. Kalan bayt döner.
+    size_t consume(size_t bytes, size_t max_frames = CAPACITY) {
+        for (size_t k = 0; count && k < max_frames; ++k) {
+            StreamFrame *f = ring[first];
+            size_t left = f->len - offset;
+            if (bytes < left) {
+                offset += bytes;
+                return 0;
+            }
+            bytes -= left;
+            offset = 0;
+            pool.release(f);
+            first = (first + 1) % CAPACITY;
+            --count;
+        }
+        return bytes;
+    }
+
+    unsigned long dropped = 0;
+
+private:
+    FramePool &pool;
+    StreamFrame *ring[CAPACITY];
+    size_t first = 0, count = 0;
+    size_t offset = 0;          // baştaki çerçevenin gönderilmiş kısmı
+};
+
+// Akışa giden bir geçiş. Zamanlama iş parçacığı varsa StreamRelay bunu geçiş anında doldurur ve
+// kuyrukla ana döngüye taşır; yoksa SignalStream kendisi doldurur.
+struct StreamEvent {
+    uint64_t seq;
+    OutputMask outputs;
+    int64_t civil_ns;           // geçişin takvim zamanı
+    const char *mode_name;      // plan ya da mod adı; planlar başlangıçtan sonra değişmez
+    uint8_t mode;
+    uint8_t cause;
+};
+
+inline const char *stream_mode_name(const ModeRunner &runner, uint8_t mode) {
+    return (Mode)mode == Mode::PLAN && runner.customPlan ? runner.customPlan->name.c_str() : mode_name((Mode)mode);
+}
+
+// Geçiş ve mod değişikliklerini abonelere yayar. Çıkış gözlemcisi olarak zaman kritik yolda çalışır:
+// satır bir kez kodlanır, her abonenin kuyruğuna yalnızca işaretçisi eklenir ve soket yazmaları için
+// on_pending bir kez çağrılır. Abone yoksa kodlama yapılmaz, yalnızca sıra numarası ilerler. --rt ile
+// gözlemci StreamRelay'dir; SignalStream geçişleri ana döngüde publish() ile alır.
+//
+// Satır biçimi ('\r' ile biter):
+//   EVENT=seq:42,time:2025-01-01 08:00:01.250,mode:SEQUENCE,cause:STEP,t1:GREEN, t2:RED, ...
+class SignalStream : public OutputObserver {
+public:
+    SignalStream(const ModeRunner &runner, CivilClock &civil)
+        : runner(runner), civil(civil), formatter(runner.head_count), last_name(stream_mode_name(runner, runner.out.mode_tag)) {}
+
+    void on_commit(OutputMask, OutputMask next, uint8_t mode, uint8_t cause) override {
+        if (subscribers.empty()) {
+            ++seq;
+            return;
+        }
+        publish({seq + 1, next, civil.now_ns(), stream_mode_name(runner, mode), mode, cause});
+    }
+
+    void publish(const StreamEvent &e) {
+        seq = e.seq;
+        last_name = e.mode_name;
+        if (subscribers.empty()) return;
+        StreamFrame *f = encode(e.outputs, e.mode_name, cause_name(e.cause), e.civil_ns);
+        for (SubscriberQueue *q : subscribers) q->push(f);
+        pool.release(f);
+        ++published;
+        if (on_pending) on_pending();
+    }
+
+    // Yeni abone, akıştan önce o anki durumu (cause:SUBSCRIBE) alır. Geçişler aktarılıyorsa mod adı son
+    // aktarılan geçiştendir; zamanlama tarafının durumu okunmaz.
+    void subscribe(SubscriberQueue &q, OutputMask current) {
+        subscribers.push_back(&q);
+        const char *name = relayed ? last_name : stream_mode_name(runner, runner.out.mode_tag);
+        StreamFrame *f = encode(current, name, "SUBSCRIBE", civil.now_ns());
+        q.push(f);
+        pool.release(f);
+    }
+
+    void unsubscribe(SubscriberQueue &q) {
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+            if (subscribers[i] != &q) continue;
+            subscribers[i] = subscribers.back();
+            subscribers.pop_back();
+            return;
+        }
+    }
+
+    size_t subscriber_count() const { return subscribers.size(); }
+
+    std::function<void()> on_pending;       // kuyruklara çerçeve eklendi; yazma sıraya konur
+    bool relayed = false;                   // geçişler StreamRelay'den gelir
+    FramePool pool;                         // kuyruklardan önce kurulur, onlardan sonra yok edilir
+    uint64_t seq = 0;                       // bütün geçişler; abone yokken de ilerler
+    unsigned long published = 0;            // kodlanıp yayılan satır sayısı
+
+private:
+    StreamFrame *encode(OutputMask outputs, const char *name, const char *cause, int64_t civil_ns) {
+        StreamFrame *f = pool.acquire();
+        time_t now = time_t(civil_ns / 1000000000);
+        if (now != when_second) {       // tarih metni saniyede bir yeniden yazılır
+            when_second = now;
+            std::tm t;
+            localtime_r(&now, &t);
+            std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &t);
+        }
+        int n = std::snprintf(f->data, StreamFrame::CAPACITY, "EVENT=seq:%llu,time:%s.%03d,mode:%.31s,cause:%s,",
+                              (unsigned long long)seq, when, int(civil_ns % 1000000000 / 1000000), name, cause);
+        size_t len = n < 0 ? 0 : (size_t)n;
+        len += formatter.format(outputs, f->data + len);
+        f->data[len++] = '\r';
+        f->len = (uint32_t)len;
+        return f;
+    }
+
+    const ModeRunner &runner;
+    CivilClock &civil;
+    SignalGroupFormatter formatter;
+    time_t when_second = -1;
+    char when[32] = {};
+    const char *last_name;
+    std::vector<SubscriberQueue *> subscribers;
+};
+
+// --rt: zamanlama iş parçacığında çıkış gözlemcisidir. Geçişi kopyalayıp kilitsiz kuyrukla ana döngüye
+// taşır; satırın kodlanması ve soket yazmaları orada yapılır. Ana döngü geride kalıp kuyruk dolarsa
+// geçiş atılır, sıra numarasındaki boşluk bunu istemciye gösterir.
+class StreamRelay : public OutputObserver {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    StreamRelay(const ModeRunner &runner, CivilClock &civil, EventLoop &loop, SignalStream &stream)
+        : runner(runner), civil(civil), loop(loop), stream(stream) {
+        stream.relayed = true;
+        loop.watch(signal.fd(), EPOLLIN, [this](uint32_t) { drain(); });
+    }
+    ~StreamRelay() override { loop.unwatch(signal.fd()); }
+
+    void on_commit(OutputMask, OutputMask next, uint8_t mode, uint8_t cause) override {
+        if (!queue.push({++seq, next, civil.now_ns(), stream_mode_name(runner, mode), mode, cause})) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        signal.notify();
+    }
+
+    std::atomic<unsigned long> dropped{0};
+
+private:
+    void drain() {
+        signal.clear();
+        StreamEvent e;
+        while (queue.pop(e)) stream.publish(e);
+    }
+
+    const ModeRunner &runner;
+    CivilClock &civil;
+    EventLoop &loop;
+    SignalStream &stream;
+    uint64_t seq = 0;               // zamanlama tarafı
+    SpscQueue<StreamEvent, CAPACITY> queue;
+    QueueSignal signal;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "clock.h"
+#include "gpio_output.h"
+
+struct LineChange {
+    Clock::time_point time;
+    int chip;
+    int offset;
+    int value;
+};
+
+// Simülasyon arka ucu: donanım yerine her hattın durumunu tutar ve her değişikliği
+// verilen saatin zamanıyla kaydeder.
+class SimBackend : public OutputBackend {
+public:
+    explicit SimBackend(const Clock &clock) : clock(clock) {}
+
+    bool request(int chip, const std::vector<int> &offs, const std::vector<int> &initial) override {
+        if (chip >= (int)offsets.size()) {
+            offsets.resize(chip + 1);
+            values.resize(chip + 1);
+        }
+        offsets[chip] = offs;
+        values[chip] = initial;
+        return true;
+    }
+
+    void set_bulk(int chip, const int *vals, unsigned count) override {
+        auto now = clock.now();
+        for (unsigned i = 0; i < count; ++i) {
+            if (values[chip][i] == vals[i]) continue;
+            values[chip][i] = vals[i];
+            if (record) changes.push_back({now, chip, offsets[chip][i], vals[i]});
+        }
+        ++calls;
+    }
+
+    bool record = true;                     // false: yalnızca son durum tutulur (yük ölçümü için)
+    std::vector<LineChange> changes;
+    std::vector<std::vector<int>> offsets;  // çip başına hat numaraları
+    std::vector<std::vector<int>> values;   // çip başına anlık değerler
+    unsigned long calls = 0;
+
+private:
+    const Clock &clock;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "clock.h"
+#include "detector_input.h"
+#include "gpio_output.h"
+
+// Simülasyon için trafik ve dedektör kaynağı. Her yaklaşıma araçlar Poisson süreciyle gelir ve kuyruğa
+// girer. Kafa yeşilken kuyruk doyma aralığıyla (headway) boşalır. Kuyruğun başındaki araç duraklama
+// çizgisi döngüsünün üzerinde bekler; geçen her araç döngüyü crossing süresince doldurur. Döngünün
+// durumu her tick'te hesaplanır ve değişimler gerçek girişteki gibi DetectorBank'a kenar olarak verilir.
+class SimTraffic {
+public:
+    Clock::duration tick = std::chrono::milliseconds(100);
+    Clock::duration headway = std::chrono::seconds(2);          // doyma akımı: 1800 araç/saat
+    Clock::duration crossing = std::chrono::milliseconds(500);  // geçen aracın döngüde kaldığı süre
+
+    SimTraffic(VirtualClock &clock, const JunctionOutput &out, DetectorBank &bank, const std::vector<double> &vehicles_per_hour,
+               unsigned seed)
+        : clock(clock), timer(clock), out(out), bank(bank), gen(seed) {
+        for (double rate : vehicles_per_hour) {
+            Approach a;
+            a.arrivals = std::exponential_distribution<double>(rate > 0 ? rate / 3600.0 : 1e-12);
+            a.next_arrival = clock.now() + interval(a);
+            approaches.push_back(a);
+        }
+        timer.on_expire([this] { step(); });
+        next_tick = clock.now() + tick;
+        timer.arm_at(next_tick);
+    }
+
+    struct Totals {
+        unsigned long arrived = 0;
+        unsigned long served = 0;
+        unsigned long queued = 0;       // simülasyon sonunda kuyrukta kalan
+        double delay_seconds = 0;       // geçen araçların toplam bekleme süresi
+        unsigned long greens = 0;       // yeşil başlangıç sayısı
+    };
+
+    Totals totals(int approach) const {
+        const Approach &a = approaches[approach];
+        return {a.arrived, a.served, (unsigned long)a.queue.size(), a.delay_seconds, a.greens};
+    }
+    int size() const { return (int)approaches.size(); }
+
+private:
+    struct Approach {
+        std::exponential_distribution<double> arrivals;
+        Clock::time_point next_arrival;
+        Clock::time_point next_departure{};
+        Clock::time_point crossing_until{};
+        std::deque<Clock::time_point> queue;    // bekleyen araçların geliş zamanları
+        bool detector = false;
+        bool was_green = false;
+        unsigned long arrived = 0;
+        unsigned long served = 0;
+        unsigned long greens = 0;
+        double delay_seconds = 0;
+    };
+
+    Clock::duration interval(Approach &a) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(a.arrivals(gen)));
+    }
+
+    void step() {
+        Clock::time_point now = clock.now();
+        OutputMask heads = out.state();
+        for (int i = 0; i < (int)approaches.size(); ++i) {
+            Approach &a = approaches[i];
+            while (a.next_arrival <= now) {
+                a.queue.push_back(a.next_arrival);
+                ++a.arrived;
+                a.next_arrival += interval(a);
+            }
+            bool green = get_head(heads, i) == SIG_GREEN;
+            if (green && !a.was_green) {
+                ++a.greens;
+                if (a.next_departure < now) a.next_departure = now;
+            }
+            a.was_green = green;
+            if (green && !a.queue.empty() && a.next_departure <= now) {
+                a.delay_seconds += std::chrono::duration<double>(now - a.queue.front()).count();
+                a.queue.pop_front();
+                ++a.served;
+                a.crossing_until = now + crossing;
+                a.next_departure = now + headway;
+            }
+            // Kırmızıda bekleyen ilk araç döngüyü doldurur; yeşilde araçlar birer birer geçer.
+            bool occupied = now < a.crossing_until || (!green && !a.queue.empty());
+            if (occupied != a.detector) {
+                a.detector = occupied;
+                bank.on_edge(i, occupied, now);
+            }
+        }
+        next_tick += tick;
+        timer.arm_at(next_tick);
+    }
+
+    VirtualClock &clock;
+    VirtualTimer timer;
+    const JunctionOutput &out;
+    DetectorBank &bank;
+    std::mt19937 gen;
+    std::vector<Approach> approaches;
+    Clock::time_point next_tick;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Tek üretici, tek tüketici kilitsiz halka. Üretici ve tüketici birbirini hiç beklemez; dolu kuyrukta
+// push false döner (kayıp üreticinin kararıdır). Baş ve kuyruk ayrı önbellek satırlarındadır, her taraf
+// diğerinin konumunu yalnızca gerektiğinde yeniden okur. N ikinin kuvveti olmalıdır.
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N && (N & (N - 1)) == 0, "kapasite ikinin kuvveti olmalı");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    // Üretici.
+    bool push(const T &v) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail_seen == N) {
+            tail_seen = tail.load(std::memory_order_acquire);
+            if (h - tail_seen == N) return false;
+        }
+        items[h & (N - 1)] = v;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Tüketici.
+    bool pop(T &v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head_seen) {
+            head_seen = head.load(std::memory_order_acquire);
+            if (t == head_seen) return false;
+        }
+        v = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head{0};
+    size_t tail_seen = 0;           // üreticinin gördüğü son kuyruk
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t head_seen = 0;           // tüketicinin gördüğü son baş
+    alignas(64) T items[N];
+};
+
+// Kuyruğa eklendiğini tüketicinin olay döngüsüne bildiren eventfd. Tüketici uyanıp boşaltana kadar
+// gelen bildirimler tek write'ta birleşir: üretici işaret zaten kalkıksa sistem çağrısı yapmaz.
+class QueueSignal {
+public:
+    QueueSignal() : efd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+    ~QueueSignal() { close(efd); }
+    QueueSignal(const QueueSignal &) = delete;
+    QueueSignal &operator=(const QueueSignal &) = delete;
+
+    int fd() const { return efd; }
+
+    // Üretici.
+    void notify() {
+        if (raised.exchange(true, std::memory_order_acq_rel)) return;
+        uint64_t one = 1;
+        ssize_t n = write(efd, &one, sizeof(one));
+        (void)n;
+    }
+
+    // Tüketici: kuyruğu boşaltmadan önce çağrılır, böylece boşaltma sırasında gelen ekleme kaybolmaz.
+    void clear() {
+        uint64_t v;
+        ssize_t n = read(efd, &v, sizeof(v));
+        (void)n;
+        raised.store(false, std::memory_order_release);
+    }
+
+private:
+    int efd;
+    std::atomic<bool> raised{false};
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Sıcak yeniden başlatma için durum kaydı. Çalışan planın konumu, çıkış maskesi, bitiş zamanları ve
+// komutlarla değişen ayarlar küçük, bellek eşlemeli bir dosyada tutulur. Her kayıt iki yuvadan
+// kullanılmayanına yazılır, ardından committed sayacı release ile ilerletilir; süreç yazarken ölse
+// bile diğer yuva tutarlıdır. Sistem çağrısı yoktur; dosya MAP_SHARED olduğundan süreç çökse de
+// sayfa önbelleğinde kalır. Zamanlar CLOCK_MONOTONIC'tir (steady_clock), bu yüzden kayıt yalnızca
+// aynı açılışta (boot_id) geçerlidir; dosya /run gibi bir tmpfs üzerinde tutulabilir.
+
+struct CheckpointState {
+    uint64_t outputs;               // çıkış maskesi (kafalar ve durum LED'i)
+    int64_t deadline_ns;            // çalışan adımın bitişi, steady_clock
+    int64_t green_start_ns;         // talebe bağlı yeşilin başlangıcı
+    int64_t last_command_ns;        // PHASE zaman aşımı için son komut anı
+    int64_t civil_offset_ns;        // SETTIME ile verilmiş saat farkı (custom_time ise)
+    uint32_t step;                  // planın adım sırası
+    int32_t minseqtimeout;
+    uint8_t mode;                   // ModeRunner::mode (Mode)
+    uint8_t activemode;             // Controller::activemode
+    uint8_t custom_time;
+    uint8_t head_count;
+    uint8_t pin_count;
+    int8_t phase_order[16];
+    int8_t sequence_order[16];
+    char plan[32];                  // Mode::PLAN için plan adı
+    uint8_t reserved[43];
+};
+static_assert(sizeof(CheckpointState) == 160, "kayıt boyutu dosya biçiminin parçasıdır");
+
+struct CheckpointHeader {
+    char magic[8];                      // "JCSTATE1"
+    uint32_t version;
+    uint32_t state_size;
+    char boot_id[40];                   // /proc/sys/kernel/random/boot_id
+    std::atomic<uint32_t> live;         // 1: denetleyici çalışıyor ya da düzgün kapanmadı
+    uint32_t reserved;
+    std::atomic<uint64_t> committed;    // yazılmış kayıt sayısı; son kayıt slots[(committed - 1) & 1]
+    CheckpointState slots[2];
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "committed paylaşımlı bellekte kilitsiz olmalı");
+
+constexpr char CHECKPOINT_MAGIC[8] = {'J', 'C', 'S', 'T', 'A', 'T', 'E', '1'};
+
+inline bool read_boot_id(char (&out)[40]) {
+    std::memset(out, 0, sizeof(out));
+    FILE *f = std::fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (!f) return false;
+    bool ok = std::fgets(out, sizeof(out), f) != nullptr;
+    std::fclose(f);
+    if (char *nl = std::strchr(out, '\n')) *nl = '\0';
+    return ok;
+}
+
+class StateCheckpoint {
+public:
+    ~StateCheckpoint() {
+        if (header) munmap(header, sizeof(CheckpointHeader));
+    }
+
+    // Dosyayı açar ya da oluşturur. Aynı açılışta yazılmış ve düzgün kapanmamış bir kayıt varsa
+    // resumable() true döner ve last() onu verir.
+    bool open(const char *path) {
+        int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        struct stat st;
+        bool reuse = fstat(fd, &st) == 0 && (size_t)st.st_size == sizeof(CheckpointHeader);
+        if (!reuse && ftruncate(fd, sizeof(CheckpointHeader)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, sizeof(CheckpointHeader), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        header = static_cast<CheckpointHeader *>(p);
+        char boot[40];
+        read_boot_id(boot);
+        resumable_ = reuse && std::memcmp(header->magic, CHECKPOINT_MAGIC, 8) == 0 && header->version == 1 &&
+                     header->state_size == sizeof(CheckpointState) && std::strcmp(header->boot_id, boot) == 0 &&
+                     header->live.load(std::memory_order_acquire) && header->committed.load(std::memory_order_acquire) > 0;
+        if (resumable_) {
+            saved = header->slots[(header->committed.load(std::memory_order_relaxed) - 1) & 1];
+        } else {
+            std::memset(p, 0, sizeof(CheckpointHeader));
+            header->version = 1;
+            header->state_size = sizeof(CheckpointState);
+            std::memcpy(header->boot_id, boot, sizeof(boot));
+            std::memcpy(header->magic, CHECKPOINT_MAGIC, 8);
+        }
+        header->live.store(1, std::memory_order_release);
+        return true;
+    }
+
+    bool is_open() const { return header != nullptr; }
+    bool resumable() const { return resumable_; }
+    const CheckpointState &last() const { return saved; }
+
+    void save(const CheckpointState &s) {
+        if (!header) return;
+        uint64_t n = header->committed.load(std::memory_order_relaxed);
+        header->slots[n & 1] = s;
+        header->committed.store(n + 1, std::memory_order_release);
+        ++saves;
+    }
+
+    // Düzgün kapanış: bir sonraki açılış soğuk başlar.
+    void close_clean() {
+        if (header) header->live.store(0, std::memory_order_release);
+    }
+
+    unsigned long saves = 0;
+
+private:
+    CheckpointHeader *header = nullptr;
+    CheckpointState saved = {};
+    bool resumable_ = false;
+};
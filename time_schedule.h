@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "civil_clock.h"
+#include "clock.h"
+
+// Haftalık zaman çizelgesi: "schedule 1-5 07:00 PEAK" satırı hafta içi her gün 07:00'de PEAK planına
+// geçilmesini ister. Günler 1 (Pazartesi) - 7 (Pazar) arasıdır, * bütün günlerdir. Bir girdi, bir sonraki
+// geçiş noktasına kadar etkindir; hafta sonundan başa sarılır.
+struct ScheduleEntry {
+    uint8_t days = 0;           // bit 0: Pazartesi ... bit 6: Pazar
+    uint32_t second = 0;        // günün saniyesi
+    std::string target;         // mod ya da plan adı
+};
+
+// Derlenmiş geçiş noktası: haftanın saniyesi ve o andan itibaren etkin olan girdi.
+struct SwitchPoint {
+    uint32_t week_second;
+    uint16_t entry;
+};
+
+class TimeSchedule {
+public:
+    std::vector<ScheduleEntry> entries;
+    std::vector<SwitchPoint> table;     // week_second'a göre sıralı, tekrarsız
+
+    bool empty() const { return table.empty(); }
+
+    // Girdiler haftanın saniyelerine açılır ve sıralanır. Aynı ana düşen girdilerden dosyada sonra gelen geçerlidir.
+    void compile() {
+        table.clear();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            for (int d = 0; d < 7; ++d) {
+                if ((entries[i].days >> d) & 1) table.push_back({uint32_t(d) * 86400 + entries[i].second, uint16_t(i)});
+            }
+        }
+        std::stable_sort(table.begin(), table.end(), [](const SwitchPoint &a, const SwitchPoint &b) { return a.week_second < b.week_second; });
+        size_t n = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (n && table[n - 1].week_second == table[i].week_second) table[n - 1] = table[i];
+            else table[n++] = table[i];
+        }
+        table.resize(n);
+    }
+
+    // Verilen anda etkin olan geçiş noktasının tablodaki yeri; ikili arama. Çizelge boşsa -1.
+    int active_point(uint32_t week_second) const {
+        if (table.empty()) return -1;
+        auto it = std::upper_bound(table.begin(), table.end(), week_second,
+                                   [](uint32_t s, const SwitchPoint &p) { return s < p.week_second; });
+        return it == table.begin() ? int(table.size()) - 1 : int(it - table.begin()) - 1;
+    }
+
+    int active(uint32_t week_second) const {
+        int p = active_point(week_second);
+        return p < 0 ? -1 : table[p].entry;
+    }
+
+    // Bir sonraki geçiş noktasına kalan saniye (1 ile bir hafta arası).
+    uint32_t until_next(uint32_t week_second) const {
+        int p = active_point(week_second);
+        if (p < 0) return CivilClock::WEEK_SECONDS;
+        uint32_t next = table[(p + 1) % table.size()].week_second;
+        return next > week_second ? next - week_second : next + CivilClock::WEEK_SECONDS - week_second;
+    }
+};
+
+// "1-5", "6,7", "*" biçimindeki gün listesi.
+inline bool parse_day_list(const std::string &text, uint8_t &days) {
+    days = 0;
+    if (text == "*") return days = 0x7f, true;
+    const char *p = text.c_str();
+    while (*p) {
+        char *end;
+        long a = std::strtol(p, &end, 10), b = a;
+        if (end == p) return false;
+        if (*end == '-') {
+            p = end + 1;
+            b = std::strtol(p, &end, 10);
+            if (end == p) return false;
+        }
+        if (a < 1 || b > 7 || a > b) return false;
+        for (long d = a; d <= b; ++d) days |= uint8_t(1 << (d - 1));
+        if (*end == ',') ++end;
+        else if (*end) return false;
+        p = end;
+    }
+    return days != 0;
+}
+
+// "07:00" ya da "07:00:30" biçimindeki saat.
+inline bool parse_time_of_day(const std::string &text, uint32_t &second) {
+    unsigned h, m, s = 0;
+    char tail;
+    int n = std::sscanf(text.c_str(), "%u:%u:%u%c", &h, &m, &s, &tail);
+    if ((n != 2 && n != 3) || h > 23 || m > 59 || s > 59) return false;
+    second = h * 3600 + m * 60 + s;
+    return true;
+}
+
+// out: std::string ya da ReplyBuffer; bellek ayırmadan yazılabilsin diye şablondur.
+template <typename Out>
+inline void append_time_of_day(Out &out, uint32_t second) {
+    char buf[16];
+    if (second % 60) std::snprintf(buf, sizeof(buf), "%02u:%02u:%02u", second / 3600, second / 60 % 60, second % 60);
+    else std::snprintf(buf, sizeof(buf), "%02u:%02u", second / 3600, second / 60 % 60);
+    out.append(buf);
+}
+
+// Çizelgeyi takvim saatine göre yürütür. Zamanlayıcı bir sonraki geçiş noktasına kurulur; saat
+// kayabileceği için en fazla bir saat sonra yeniden bakılır. Etkin girdi değişince on_switch çağrılır.
+class ModeScheduler {
+public:
+    ModeScheduler(const TimeSchedule &schedule, CivilClock &civil, const Clock &clock, DeadlineTimer &timer)
+        : schedule(schedule), civil(civil), clock(clock), timer(timer) {
+        timer.on_expire([this] { resync(); });
+    }
+
+    const TimeSchedule &schedule;
+    std::function<void(int entry)> on_switch;
+    int current = -1;           // etkin girdi
+
+    // Etkin girdiyi belirler ve zamanlayıcıyı kurar; girdi çağırana döner, on_switch çağrılmaz.
+    int start() {
+        point = schedule.active_point(civil.week_second());
+        current = point < 0 ? -1 : schedule.table[point].entry;
+        arm();
+        return current;
+    }
+
+    // Saat ya da zaman dilimi değiştiğinde ve zamanlayıcı dolduğunda çağrılır. Bir geçiş noktası
+    // aşıldıysa girdisi, elle verilmiş bir modun üzerine yeniden uygulanır.
+    void resync() {
+        int p = schedule.active_point(civil.week_second());
+        arm();
+        if (p != point) {
+            point = p;
+            current = p < 0 ? -1 : schedule.table[p].entry;
+            if (on_switch) on_switch(current);
+        }
+    }
+
+    uint32_t seconds_to_next() { return schedule.until_next(civil.week_second()); }
+
+private:
+    void arm() {
+        if (schedule.empty()) return timer.disarm();
+        uint32_t wait = std::min<uint32_t>(schedule.until_next(civil.week_second()), 3600);
+        timer.arm_at(clock.now() + std::chrono::seconds(wait) - std::chrono::nanoseconds(civil.subsecond_ns()));
+    }
+
+    CivilClock &civil;
+    const Clock &clock;
+    DeadlineTimer &timer;
+    int point = -1;             // etkin geçiş noktası
+};
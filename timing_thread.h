@@ -0,0 +1,234 @@
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "event_log.h"
+#include "event_loop.h"
+#include "rt_thread.h"
+#include "spsc_queue.h"
+#include "state_checkpoint.h"
+
+// Zamanlama iş parçacığı (--rt). Plan yürütücüsünün, zaman aşımının ve çizelgenin zamanlayıcıları,
+// dedektör girişleri ve GPIO yazmaları bu iş parçacığının kendi olay döngüsünde (loop) çalışır.
+// Komut girişi, soketler, seri hat, iz dosyası ve ekran normal öncelikteki ana döngüde kalır ve
+// zamanlama tarafına yalnızca kilitsiz kuyruklarla ulaşır:
+//   call()          komutun durum değiştiren kısmı kuyruğa konur, bitmesi beklenir (ana taraf bekler,
+//                   zamanlama tarafı hiçbir zaman ana tarafı beklemez); dosya işi olan komutlarda o kısım
+//                   önce ana tarafta yapılır (CommandSpec::io)
+//   NoticeRelay     zamanlama tarafındaki ekran mesajları ana döngüde yazılır
+//   StreamRelay     geçişler SUBSCRIBE akışına ana döngüde kodlanır (signal_stream.h)
+//   EventLogRelay   geçişler olay kaydı dosyasına ana döngüde yazılır
+//   CheckpointRelay durum kaydının son hali dosyaya ana döngüde yazılır
+// Olay kaydı ve durum kaydı diskteki dosyaların eşlemleridir; geri yazılan bir sayfaya ilk yazma dosya
+// sisteminde bekleyebilir, bu yüzden zamanlama tarafı onlara dokunmaz. /dev/shm segmenti bellektedir
+// ve zamanlama tarafında yazılır.
+// Başlatılmadan önce call() işi hemen çağıranın iş parçacığında yapar; kurulum ve ilk adım böylece
+// tek iş parçacığında kalır.
+class TimingThread {
+public:
+    TimingThread() : done_fd(eventfd(0, EFD_CLOEXEC)) {
+        loop.watch(wake.fd(), EPOLLIN, [this](uint32_t) { run_calls(); });
+    }
+    ~TimingThread() {
+        stop();
+        loop.unwatch(wake.fd());
+        close(done_fd);
+    }
+    TimingThread(const TimingThread &) = delete;
+    TimingThread &operator=(const TimingThread &) = delete;
+
+    bool start(const RtConfig &config, std::string &error) {
+        return thread.start(config, [this] { loop.run(); }, error);
+    }
+
+    void stop() {
+        if (!thread.running()) return;
+        call([this] { loop.stop(); });
+        thread.join();
+    }
+
+    // f zamanlama iş parçacığında çalışır, bitene kadar beklenir. Tek bir iş parçacığından (ana döngü)
+    // çağrılır; f çağıranın yığınındadır ve bellek ayrılmaz.
+    template <typename F>
+    void call(F &&f) {
+        if (!thread.running() || thread.is_current()) {
+            f();
+            return;
+        }
+        using Fn = std::remove_reference_t<F>;
+        Call c{[](void *p) { (*static_cast<Fn *>(p))(); }, const_cast<void *>(static_cast<const void *>(&f)), ++issued};
+        while (!calls.push(c)) sched_yield();       // tek çağıran: kuyrukta en çok bir iş olur
+        wake.notify();
+        while (completed.load(std::memory_order_acquire) < c.id) {
+            uint64_t v;
+            ssize_t n = read(done_fd, &v, sizeof(v));
+            (void)n;
+        }
+    }
+
+    bool running() const { return thread.running(); }
+    const RtThread &rt() const { return thread; }
+
+    EventLoop loop;
+
+private:
+    struct Call {
+        void (*fn)(void *);
+        void *ctx;
+        uint64_t id;
+    };
+
+    void run_calls() {
+        wake.clear();
+        Call c;
+        while (calls.pop(c)) {
+            c.fn(c.ctx);
+            completed.store(c.id, std::memory_order_release);
+            uint64_t one = 1;
+            ssize_t n = write(done_fd, &one, sizeof(one));
+            (void)n;
+        }
+    }
+
+    RtThread thread;
+    SpscQueue<Call, 8> calls;
+    QueueSignal wake;
+    int done_fd;                        // tamamlanan iş; çağıran bloklayan read ile bekler
+    uint64_t issued = 0;
+    std::atomic<uint64_t> completed{0};
+};
+
+// Zamanlama tarafındaki ekran mesajlarını (zaman aşımı, çakışma, çizelge) ana döngüye taşır; std::cout
+// zamanlama iş parçacığında hiç çağrılmaz. Kuyruk doluysa mesaj atılır ve sayılır.
+class NoticeRelay {
+public:
+    static constexpr size_t MAX_TEXT = 240;
+
+    NoticeRelay(EventLoop &loop, std::function<void(std::string_view)> sink) : loop(loop), sink(std::move(sink)) {
+        loop.watch(signal.fd(), EPOLLIN, [this](uint32_t) { drain(); });
+    }
+    ~NoticeRelay() { loop.unwatch(signal.fd()); }
+
+    // Zamanlama tarafı.
+    void post(std::string_view text) {
+        Notice n;
+        n.len = (uint16_t)std::min(text.size(), MAX_TEXT);
+        std::memcpy(n.text, text.data(), n.len);
+        if (!queue.push(n)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        signal.notify();
+    }
+
+    std::atomic<unsigned long> dropped{0};
+
+private:
+    struct Notice {
+        uint16_t len;
+        char text[MAX_TEXT];
+    };
+
+    void drain() {
+        signal.clear();
+        Notice n;
+        while (queue.pop(n)) sink(std::string_view(n.text, n.len));
+    }
+
+    EventLoop &loop;
+    std::function<void(std::string_view)> sink;
+    SpscQueue<Notice, 16> queue;
+    QueueSignal signal;
+};
+
+// Olay kaydının zamanlama tarafındaki gözlemcisi. Geçiş, olduğu anın zaman damgasıyla kuyruğa konur;
+// kayıt ana döngüde yazılır. Kuyruk doluysa geçiş atılır ve sayılır.
+class EventLogRelay : public OutputObserver {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    EventLogRelay(EventLoop &loop, EventLog &log) : loop(loop), log(log) {
+        loop.watch(signal.fd(), EPOLLIN, [this](uint32_t) { drain(); });
+    }
+    ~EventLogRelay() override { loop.unwatch(signal.fd()); }
+
+    void on_commit(OutputMask prev, OutputMask next, uint8_t mode, uint8_t cause) override {
+        if (!queue.push({prev, next, EventLog::realtime_ns(), mode, cause})) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        signal.notify();
+    }
+
+    // Ana taraf; zamanlama iş parçacığı durduktan sonra kalanlar için de çağrılır.
+    void drain() {
+        signal.clear();
+        Commit c;
+        while (queue.pop(c)) log.record(c.prev, c.next, c.mode, c.cause, c.time_ns);
+    }
+
+    std::atomic<unsigned long> dropped{0};
+
+private:
+    struct Commit {
+        OutputMask prev, next;
+        uint64_t time_ns;
+        uint8_t mode, cause;
+    };
+
+    EventLoop &loop;
+    EventLog &log;
+    SpscQueue<Commit, CAPACITY> queue;
+    QueueSignal signal;
+};
+
+// Durum kaydının zamanlama tarafından ana döngüye taşınması. Yalnızca son durum önemlidir: zamanlama
+// tarafı tek bir yuvaya seqlock ile yazar ve hiç beklemez; ana döngü tutarlı bir kopya alıp dosyaya
+// yazar. Kopya sırasında yeni yazma olduysa onun bildirimiyle yeniden okunur.
+class CheckpointRelay {
+public:
+    CheckpointRelay(EventLoop &loop, StateCheckpoint &checkpoint) : loop(loop), checkpoint(checkpoint) {
+        loop.watch(signal.fd(), EPOLLIN, [this](uint32_t) { drain(); });
+    }
+    ~CheckpointRelay() { loop.unwatch(signal.fd()); }
+
+    // Zamanlama tarafı.
+    void post(const CheckpointState &s) {
+        uint64_t v = seq.load(std::memory_order_relaxed);
+        seq.store(v + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot, &s, sizeof(s));
+        seq.store(v + 2, std::memory_order_release);
+        signal.notify();
+    }
+
+    // Ana taraf; zamanlama iş parçacığı durduktan sonra son durum için de çağrılır.
+    void drain() {
+        signal.clear();
+        uint64_t v = seq.load(std::memory_order_acquire);
+        if (v == saved || (v & 1)) return;
+        CheckpointState s;
+        std::memcpy(&s, &slot, sizeof(s));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) != v) return;
+        checkpoint.save(s);
+        saved = v;
+    }
+
+private:
+    EventLoop &loop;
+    StateCheckpoint &checkpoint;
+    std::atomic<uint64_t> seq{0};
+    CheckpointState slot = {};
+    uint64_t saved = 0;             // ana taraf: dosyaya yazılan son sürüm
+    QueueSignal signal;
+};
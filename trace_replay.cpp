@@ -0,0 +1,418 @@
+// Protokol izini yeniden oynatan ve yapay komut karışımı üreten yük üreticisi. --trace ile
+// kontrolcünün --trace seçeneğiyle kaydettiği iz, kayıttaki zamanlamayla (--speed 1), hızlandırılarak
+// ya da bekleme olmadan (--speed 0) gönderilir; izdeki her kaynak (soket istemcisi, seri hat,
+// standart giriş) ayrı bir bağlantıdan oynatılır ve yanıtlar izdekilerle karşılaştırılır. --mix ile
+// GETSIGNALGROUP/SETMODE/SETPHASEORDER gibi komutlar verilen oranlarda ve --rate hızında (0: doyuma
+// kadar) üretilir.
+//
+// Gecikme, komutun gönderilmesi gereken andan yanıtın geldiği ana kadar ölçülür; kontrolcü geride
+// kalırsa bekleyen komutların gecikmesi de sayılır. Yükün zamanlamaya etkisi, çalışmadan önce ve
+// sonra alınan GETSTATS'teki adım gecikmesinden (step_late_us) raporlanır. Sonuçlar CSV olarak
+// verilir. --inproc kontrolcüyü sahte GPIO arka ucuyla aynı süreçte bir Unix soketinde çalıştırır.
+//
+// Derleme: cmake -S . -B build && cmake --build build --target trace_replay
+// Kullanım: trace_replay (--unix PATH | --tcp HOST:PORT | --inproc)
+//                        (--trace FILE [--speed 1] | [--mix GETSIGNALGROUP:98,SETMODE:1,SETPHASEORDER:1] [--rate 2000]
+//                         [--clients 4] [--seconds 5]) [--pipeline 32]
+//           trace_replay --dump FILE
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "command_server.h"
+#include "controller.h"
+#include "event_loop.h"
+#include "gpio_output.h"
+#include "mode_runner.h"
+#include "pin_map.h"
+#include "protocol_trace.h"
+
+using steady = std::chrono::steady_clock;
+
+struct Target {
+    std::string unix_path;
+    std::string host = "127.0.0.1";
+    int port = 0;
+};
+
+static int connect_to(const Target &t) {
+    int fd;
+    if (!t.unix_path.empty()) {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, t.unix_path.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0) return fd;
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(t.port);
+        inet_pton(AF_INET, t.host.c_str(), &addr.sin_addr);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0) return fd;
+    }
+    close(fd);
+    return -1;
+}
+
+// Bir bağlantıdan gönderilecek komut. at: başlangıçtan itibaren gönderim anı (sn), < 0 ise hemen.
+struct Outgoing {
+    std::string command;
+    double at = -1;
+    std::string expected;       // izdeki yanıt (yalnızca yeniden oynatmada)
+};
+
+struct ClientResult {
+    std::vector<double> latencies_us;
+    unsigned long sent = 0, errors = 0, reply_diff = 0;
+};
+
+// Komutlar zamanı gelince gönderilir, en fazla window komut yanıt bekleyebilir. next(out) false
+// dönünce gönderim biter, bekleyen yanıtlar okunur.
+template <typename Next>
+static void client_loop(const Target &t, steady::time_point t0, int window, Next next, ClientResult &res) {
+    int fd = connect_to(t);
+    if (fd < 0) {
+        ++res.errors;
+        return;
+    }
+    struct Pending {
+        steady::time_point due;
+        std::string expected;
+    };
+    std::deque<Pending> pending;
+    std::this_thread::sleep_until(t0);
+    Outgoing o;
+    bool more = next(o);
+    std::string line, batch;
+    char buf[16384];
+    while (more || !pending.empty()) {
+        auto now = steady::now();
+        batch.clear();
+        while (more && (int)pending.size() < window && (o.at < 0 || t0 + std::chrono::duration<double>(o.at) <= now)) {
+            auto due = o.at < 0 ? now : t0 + std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(o.at));
+            batch += o.command;
+            batch += '\r';
+            pending.push_back({due, std::move(o.expected)});
+            ++res.sent;
+            o = Outgoing();
+            more = next(o);
+        }
+        if (!batch.empty() && write(fd, batch.data(), batch.size()) != (ssize_t)batch.size()) {
+            ++res.errors;
+            break;
+        }
+        int timeout = 2000;     // yanıt gelmezse bağlantı kopmuş sayılır
+        if (more && (int)pending.size() < window && o.at >= 0) {
+            auto wait = t0 + std::chrono::duration<double>(o.at) - steady::now();
+            timeout = std::max(0, (int)std::chrono::duration_cast<std::chrono::milliseconds>(wait).count());
+        }
+        pollfd p = {fd, POLLIN, 0};
+        int r = poll(&p, 1, timeout);
+        if (r == 0 && !pending.empty() && timeout == 2000) {
+            res.errors += pending.size();
+            break;
+        }
+        if (r <= 0) continue;
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+            res.errors += pending.size();
+            break;
+        }
+        now = steady::now();
+        for (ssize_t i = 0; i < n; ++i) {
+            if (buf[i] != '\r') {
+                line.push_back(buf[i]);
+                continue;
+            }
+            if (pending.empty()) {      // beklenmeyen yanıt
+                ++res.errors;
+            } else {
+                Pending &f = pending.front();
+                res.latencies_us.push_back(std::chrono::duration<double, std::micro>(now - f.due).count());
+                std::string_view want = f.expected;
+                if (!want.empty() && want.back() == '\n') want.remove_suffix(1);
+                if (!f.expected.empty() && line != want) ++res.reply_diff;
+                pending.pop_front();
+            }
+            line.clear();
+        }
+    }
+    close(fd);
+}
+
+// GETSTATS yanıtından "STATS.step_late_us=count:N,...,p99:X,...,max:Y" satırı.
+struct StepLate {
+    unsigned long count = 0;
+    double p99 = 0, max = 0;
+};
+
+static bool query_step_late(const Target &t, StepLate &s) {
+    int fd = connect_to(t);
+    if (fd < 0) return false;
+    std::string reply;
+    char buf[4096];
+    bool ok = write(fd, "GETSTATS\r", 9) == 9;
+    pollfd p = {fd, POLLIN, 0};
+    while (ok && reply.find('\r') == std::string::npos && poll(&p, 1, 2000) == 1) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        reply.append(buf, n);
+    }
+    close(fd);
+    size_t at = reply.find("STATS.step_late_us=");
+    if (at == std::string::npos) return false;
+    const char *line = reply.c_str() + at;
+    const char *c = std::strstr(line, "count:"), *p99 = std::strstr(line, ",p99:"), *max = std::strstr(line, ",max:");
+    if (!c || !p99 || !max) return false;
+    s.count = std::strtoul(c + 6, nullptr, 10);
+    s.p99 = std::atof(p99 + 5);
+    s.max = std::atof(max + 5);
+    return true;
+}
+
+static double percentile(std::vector<double> &v, double p) {
+    if (v.empty()) return 0;
+    size_t idx = std::min(v.size() - 1, (size_t)(p / 100.0 * v.size()));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+// "GETSIGNALGROUP:98,SETMODE:1,SETPHASEORDER:1"
+static bool parse_mix(const char *s, std::vector<std::pair<std::string, double>> &mix) {
+    mix.clear();
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t colon = item.find(':');
+        if (colon == std::string::npos || colon == 0) return false;
+        double w = std::atof(item.c_str() + colon + 1);
+        if (w <= 0) return false;
+        mix.push_back({item.substr(0, colon), w});
+    }
+    return !mix.empty();
+}
+
+// Karışımdaki komut adından gönderilecek komut: ayar komutlarına geçerli rastgele değerler verilir.
+static std::string make_command(const std::string &name, std::mt19937 &rng) {
+    if (name == "SETMODE") return rng() % 2 ? "SETMODE=SEQUENCE" : "SETMODE=PHASE";
+    if (name == "SETPHASEORDER" || name == "SETSEQORDER") {
+        std::string order[] = {"t1", "t2", "t3", "t4"};
+        std::shuffle(std::begin(order), std::end(order), rng);
+        return name + "=" + order[0] + "-" + order[1] + "-" + order[2] + "-" + order[3];
+    }
+    return name;
+}
+
+static int dump_trace(const char *path) {
+    ProtocolTraceReader reader;
+    std::string error;
+    if (!reader.open(path, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::printf("time_s,source,service_us,command,reply\n");
+    TraceEntry e;
+    while (reader.next(e)) {
+        std::string reply(e.reply.substr(0, e.reply.find('\n')));
+        std::printf("%.6f,%u,%.1f,\"%.*s\",\"%s%s\"\n", e.rec.time_ns / 1e9, e.rec.source, e.rec.service_ns / 1e3, (int)e.command.size(),
+                    e.command.data(), reply.c_str(), reply.size() + 1 < e.reply.size() ? "..." : "");
+    }
+    return 0;
+}
+
+// Sahte GPIO arka uçlu kontrolcü, ayrı iş parçacığında bir Unix soketinde.
+class InprocController {
+public:
+    explicit InprocController(const std::string &path)
+        : out(backend, default_pins()), runner(out, clock, modeTimer, HEAD_COUNT), controller(out, runner, clock, timeoutTimer),
+          server(loop, controller) {
+        out.init(0);
+        controller.start();
+        ok = server.listen_unix(path) && pipe(wake) == 0;
+        if (!ok) return;
+        loop.watch(wake[0], EPOLLIN, [this](uint32_t) { loop.stop(); });
+        thread = std::thread([this] { loop.run(); });
+    }
+
+    ~InprocController() {
+        if (thread.joinable()) {
+            char c = 0;
+            if (write(wake[1], &c, 1) == 1) thread.join();
+        }
+    }
+
+    bool ok = false;
+
+private:
+    EventLoop loop;
+    SteadyClock clock;
+    Timer modeTimer{loop}, timeoutTimer{loop};
+    MockBackend backend;
+    JunctionOutput out;
+    ModeRunner runner;
+    Controller controller;
+    CommandServer server;
+    int wake[2] = {-1, -1};
+    std::thread thread;
+};
+
+int main(int argc, char **argv) {
+    Target target;
+    bool inproc = false;
+    const char *trace_file = nullptr, *mix_arg = "GETSIGNALGROUP:98,SETMODE:1,SETPHASEORDER:1";
+    double speed = 1, rate = 2000, seconds = 5;
+    int clients = 4, window = 32;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--dump" && i + 1 < argc) return dump_trace(argv[++i]);
+        if (a == "--unix" && i + 1 < argc) target.unix_path = argv[++i];
+        else if (a == "--tcp" && i + 1 < argc) {
+            std::string hp = argv[++i];
+            size_t colon = hp.rfind(':');
+            target.host = hp.substr(0, colon);
+            target.port = std::atoi(hp.c_str() + colon + 1);
+        } else if (a == "--inproc") inproc = true;
+        else if (a == "--trace" && i + 1 < argc) trace_file = argv[++i];
+        else if (a == "--speed" && i + 1 < argc) speed = std::atof(argv[++i]);
+        else if (a == "--mix" && i + 1 < argc) mix_arg = argv[++i];
+        else if (a == "--rate" && i + 1 < argc) rate = std::atof(argv[++i]);
+        else if (a == "--clients" && i + 1 < argc) clients = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--seconds" && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (a == "--pipeline" && i + 1 < argc) window = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr,
+                         "Kullanım: %s (--unix PATH | --tcp HOST:PORT | --inproc) (--trace FILE [--speed X] | [--mix CMD:W,...]"
+                         " [--rate CMD/S] [--clients N] [--seconds S]) [--pipeline N]\n       %s --dump FILE\n",
+                         argv[0], argv[0]);
+            return 1;
+        }
+    }
+    std::vector<std::pair<std::string, double>> mix;
+    if (!trace_file && !parse_mix(mix_arg, mix)) {
+        std::fprintf(stderr, "Geçersiz karışım: %s\n", mix_arg);
+        return 1;
+    }
+
+    std::ostringstream silent;      // süreç içi kontrolcünün mesajları CSV'ye karışmasın
+    std::streambuf *saved_cout = std::cout.rdbuf(silent.rdbuf());
+    std::unique_ptr<InprocController> local;
+    if (inproc) {
+        target.unix_path = "/tmp/trace_replay_" + std::to_string(getpid()) + ".sock";
+        local = std::make_unique<InprocController>(target.unix_path);
+        if (!local->ok) {
+            std::cout.rdbuf(saved_cout);
+            std::fprintf(stderr, "Süreç içi kontrolcü başlatılamadı\n");
+            return 1;
+        }
+    }
+    if (target.unix_path.empty() && !target.port) {
+        std::cout.rdbuf(saved_cout);
+        std::fprintf(stderr, "--unix, --tcp ya da --inproc gerekli\n");
+        return 1;
+    }
+
+    // Yeniden oynatmada her kaynak kendi bağlantısından, kayıttaki sırayla gönderilir.
+    std::map<uint16_t, std::vector<Outgoing>> streams;
+    if (trace_file) {
+        ProtocolTraceReader reader;
+        std::string error;
+        if (!reader.open(trace_file, error)) {
+            std::cout.rdbuf(saved_cout);
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        TraceEntry e;
+        while (reader.next(e)) {
+            std::string_view cmd = e.command;
+            while (!cmd.empty() && (cmd.back() == '\r' || cmd.back() == '\n')) cmd.remove_suffix(1);
+            if (cmd.empty()) continue;
+            streams[e.rec.source].push_back({std::string(cmd), speed > 0 ? e.rec.time_ns / 1e9 / speed : -1, std::string(e.reply)});
+        }
+        clients = (int)streams.size();
+    }
+
+    StepLate before, after;
+    bool stats = query_step_late(target, before);
+    std::vector<ClientResult> results(clients);
+    std::vector<std::thread> threads;
+    auto t0 = steady::now() + std::chrono::milliseconds(20);    // bütün bağlantılar kurulduktan sonra
+    if (trace_file) {
+        int c = 0;
+        for (auto &s : streams) {
+            threads.emplace_back([&, c, cmds = &s.second] {
+                size_t k = 0;
+                client_loop(target, t0, window, [&](Outgoing &o) { return k < cmds->size() ? (o = (*cmds)[k++], true) : false; },
+                            results[c]);
+            });
+            ++c;
+        }
+    } else {
+        double total_weight = 0;
+        for (auto &m : mix) total_weight += m.second;
+        for (int c = 0; c < clients; ++c) {
+            threads.emplace_back([&, c] {
+                std::mt19937 rng(1234 + c);
+                std::uniform_real_distribution<double> pick(0, total_weight);
+                double interval = rate > 0 ? clients / rate : 0;
+                unsigned long k = 0;
+                auto end = t0 + std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(seconds));
+                client_loop(target, t0, window,
+                            [&](Outgoing &o) {
+                                if (rate > 0 ? k * interval >= seconds : steady::now() >= end) return false;
+                                double w = pick(rng);
+                                size_t m = 0;
+                                while (m + 1 < mix.size() && w >= mix[m].second) w -= mix[m++].second;
+                                o.command = make_command(mix[m].first, rng);
+                                o.at = rate > 0 ? k * interval : -1;
+                                ++k;
+                                return true;
+                            },
+                            results[c]);
+            });
+        }
+    }
+    for (auto &t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(steady::now() - t0).count();
+    stats = query_step_late(target, after) && stats;
+    local.reset();
+    std::cout.rdbuf(saved_cout);
+
+    std::vector<double> all;
+    unsigned long sent = 0, errors = 0, diff = 0;
+    for (auto &r : results) {
+        all.insert(all.end(), r.latencies_us.begin(), r.latencies_us.end());
+        sent += r.sent;
+        errors += r.errors;
+        diff += r.reply_diff;
+    }
+    double p50 = percentile(all, 50), p99 = percentile(all, 99), p999 = percentile(all, 99.9);
+    double max = all.empty() ? 0 : *std::max_element(all.begin(), all.end());
+    std::printf("source,clients,target_rate,sent,replies,seconds,throughput_per_s,p50_us,p99_us,p999_us,max_us,errors,reply_diff,"
+                "steps,step_late_p99_us,step_late_max_before_us,step_late_max_after_us\n");
+    std::printf("%s,%d,%.0f,%lu,%zu,%.3f,%.0f,%.1f,%.1f,%.1f,%.1f,%lu,%lu,", trace_file ? "trace" : "mix", clients,
+                trace_file ? 0 : rate, sent, all.size(), elapsed, all.size() / elapsed, p50, p99, p999, max, errors, diff);
+    if (stats) std::printf("%lu,%.1f,%.1f,%.1f\n", after.count - before.count, after.p99, before.max, after.max);
+    else std::printf(",,,\n");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// İş çalan iş parçacığı havuzu. Görevler başta işçilere ardışık bloklar halinde dağıtılır; her işçi
+// kendi kuyruğunun sonundan alır, kuyruğu boşalınca diğer işçilerin kuyruklarının başından çalar.
+// Görev maliyetleri çok farklı olduğunda (uzun çevrimlerde çok daha fazla aday vardır) bütün
+// çekirdekler sonuna kadar meşgul kalır. Görevler çalışırken yeni görev eklenmez; bütün kuyruklar
+// boşalınca run() döner.
+template <typename Task>
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads) : queues(threads ? threads : 1) {}
+
+    unsigned size() const { return (unsigned)queues.size(); }
+
+    // body(task, worker) her görev için bir kez, worker 0..size()-1 olmak üzere çağrılır.
+    template <typename Body>
+    void run(const std::vector<Task> &tasks, Body body) {
+        size_t n = queues.size();
+        for (size_t w = 0; w < n; ++w) {
+            queues[w].tasks.assign(tasks.begin() + tasks.size() * w / n, tasks.begin() + tasks.size() * (w + 1) / n);
+            queues[w].steals = 0;
+        }
+        std::vector<std::thread> threads;
+        for (unsigned w = 1; w < n; ++w) threads.emplace_back([this, w, &body] { work(w, body); });
+        work(0, body);
+        for (auto &t : threads) t.join();
+    }
+
+    unsigned long steals() const {
+        unsigned long total = 0;
+        for (const Queue &q : queues) total += q.steals;
+        return total;
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        unsigned long steals = 0;
+    };
+
+    template <typename Body>
+    void work(unsigned w, Body &body) {
+        Task task;
+        while (pop(w, task) || steal(w, task)) body(task, w);
+    }
+
+    bool pop(unsigned w, Task &task) {
+        Queue &q = queues[w];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.tasks.empty()) return false;
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(unsigned w, Task &task) {
+        for (size_t i = 1; i < queues.size(); ++i) {
+            Queue &victim = queues[(w + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.tasks.empty()) continue;
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            ++queues[w].steals;     // yalnızca w işçisi yazar
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<Queue> queues;
+};